@@ -0,0 +1,748 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <memory>
+#include <array>
+#include <thread>
+#include <algorithm>            // any_of, max, min
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <optional>
+
+#include "common.h"
+#include "runner.h"
+#include "days.h"
+#include "thread_pool.h"
+#include "perf_counters.h"
+#include "result_cache.h"
+#include "instrument.h"
+#define AOC_ALLOC_HOOKS
+#include "alloc_tracker.h"
+
+
+// Command line options
+struct Options {
+    std::vector<int> days;
+    bool run_part1 = true;
+    bool run_part2 = true;
+    std::string data_dir = AOC_DATA_DIR;
+    int jobs = -1;
+    std::string alloc_budget_path;
+    bool perf = false;
+    std::string check_path, write_baseline_path;
+    int tolerance_pct = 20;
+    bool model_cache = false;
+    std::string result_cache_dir;
+    int result_cache_mb = 16;
+};
+
+// Result of running a single day
+struct DayResult {
+    int day = 0;
+    std::string answer1{}, answer2{};
+    double parse_ms = 0, part1_ms = 0, part2_ms = 0;
+    std::array<alloc::Stats, 3> allocs{};
+    std::array<perf::Sample, 3> counters{};
+    runner::CacheStatus cache = runner::CacheStatus::NONE;
+    std::string error{};
+};
+
+// A single scheduled unit of work in parallel mode
+struct TaskResult {
+    int day = 0;
+    const char *phase = "";
+    std::string answer{};
+    std::string error{};
+    int worker = -1;
+    double start_ms = 0, duration_ms = 0;
+    alloc::Stats allocs{};
+    runner::CacheStatus cache = runner::CacheStatus::NONE;
+};
+
+// Expected answer and time of a single day's phase, from the baseline file
+struct Baseline {
+    int day;
+    std::string phase;
+    std::string answer;
+    double ms;
+};
+
+// Allocations of a single day's phase
+struct PhaseAllocs {
+    int day;
+    const char *phase;
+    alloc::Stats stats;
+};
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " [options] [days...]" << std::endl
+              << "  days            Days to run, e.g. 1 5 7-9 (default: all)" << std::endl
+              << "  -p, --part N    Only run part N (1 or 2)" << std::endl
+              << "  -d, --data DIR  Directory holding the dayN.txt inputs (default: " << AOC_DATA_DIR << ")" << std::endl
+              << "  -j, --jobs N    Run parses and parts as tasks on N threads (0: one per core)" << std::endl
+              << "  --perf          Read hardware counters around each phase (not with --jobs)" << std::endl
+              << "  --model-cache   Load parsed models from (or save them to) binary files next to the inputs" << std::endl
+              << "  --result-cache DIR   Reuse answers solved before for the same input, stored in DIR" << std::endl
+              << "  --result-cache-size MB  Evict least recently used answers above this size (default: 16)" << std::endl
+              << "  --alloc-budget FILE  Fail if a phase exceeds its allocation budget (needs AOC_ALLOC_TRACKING)" << std::endl
+              << "  --check FILE         Check answers and times against a baseline file, fail on a regression" << std::endl
+              << "  --tolerance PCT      Slowdown allowed by --check (default: 20)" << std::endl
+              << "  --write-baseline FILE  Measure and write a new baseline file" << std::endl
+              << "  -h, --help      Show this message" << std::endl;
+}
+
+
+/**
+ * Parse the command line
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Options to fill
+ * @return True if the command line is valid
+ */
+bool parse_args(int argc, char **argv, Options & options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            exit(0);
+        } else if ((arg == "-p" || arg == "--part") && i + 1 < argc) {
+            std::string part = argv[++i];
+            if (part != "1" && part != "2") {return false;}
+            options.run_part1 = (part == "1");
+            options.run_part2 = (part == "2");
+        } else if ((arg == "-d" || arg == "--data") && i + 1 < argc) {
+            options.data_dir = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+            try {
+                options.jobs = common::to_number<int>(argv[++i]);
+            } catch (const std::exception &) {
+                return false;
+            }
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else if (arg == "--model-cache") {
+            options.model_cache = true;
+        } else if (arg == "--result-cache" && i + 1 < argc) {
+            options.result_cache_dir = argv[++i];
+        } else if (arg == "--result-cache-size" && i + 1 < argc) {
+            try {
+                options.result_cache_mb = common::to_number<int>(argv[++i]);
+            } catch (const std::exception &) {
+                return false;
+            }
+            if (options.result_cache_mb < 0) {return false;}
+        } else if (arg == "--alloc-budget" && i + 1 < argc) {
+            options.alloc_budget_path = argv[++i];
+        } else if (arg == "--check" && i + 1 < argc) {
+            options.check_path = argv[++i];
+        } else if (arg == "--write-baseline" && i + 1 < argc) {
+            options.write_baseline_path = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            try {
+                options.tolerance_pct = common::to_number<int>(argv[++i]);
+            } catch (const std::exception &) {
+                return false;
+            }
+        } else if (!runner::parse_days(arg, FACTORIES.size(), options.days)) {
+            return false;
+        }
+    }
+
+    // Default to all days
+    if (options.days.empty()) {
+        for (std::size_t day = 1; day <= FACTORIES.size(); ++day) {
+            options.days.push_back(day);
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Load, parse and solve the requested parts of a single day. With a result cache,
+ * cached answers are looked up during the parse phase and the parse is skipped if
+ * every requested part has one.
+ * @param day The day to run
+ * @param options The run options
+ * @param counters Hardware counters to read around each phase, or nullptr
+ * @param results Cache of solved answers, or nullptr
+ * @return The answers and timings
+ */
+DayResult run_day(int day, const Options & options, perf::Counters *counters, result_cache::Cache *results = nullptr) {
+    DayResult result{.day = day};
+    std::unique_ptr<runner::Solver> solver = FACTORIES[day - 1]();
+    runner::Stopwatch stopwatch;
+    alloc::Phase phase;
+
+    auto begin_phase = [&]() {
+        stopwatch.reset();
+        phase.start();
+        if (counters) {counters->start();}
+    };
+    auto end_phase = [&](int idx, double & ms) {
+        if (counters) {result.counters[idx] = counters->stop();}
+        ms = stopwatch.elapsed_ms();
+        result.allocs[idx] = phase.stop();
+    };
+
+    const std::string day_name = "day" + std::to_string(day);
+    AOC_TRACE_SCOPE(day_name, "day");
+    try {
+        common::Input input;
+        std::array<result_cache::Key, 2> keys;
+        std::array<std::optional<std::string>, 2> cached;
+        {
+            AOC_TRACE_SCOPE(day_name + " parse", "phase");
+            begin_phase();
+            const std::string input_path = options.data_dir + "/" + day_name + ".txt";
+            input = common::Input::from_file(input_path);
+            if (results) {
+                uint64_t hash = model_cache::content_hash(input.view());
+                for (int part = 1; part <= 2; ++part) {
+                    keys[part - 1] = {day, part, SOLVER_VERSIONS[day - 1], hash};
+                    bool requested = (part == 1) ? options.run_part1 : options.run_part2;
+                    if (requested) {cached[part - 1] = results->get(keys[part - 1]);}
+                }
+            }
+            bool need_parse = (options.run_part1 && !cached[0]) || (options.run_part2 && !cached[1]);
+            if (need_parse && options.model_cache) {
+                result.cache = solver->parse_cached(input.view(), input_path);
+            } else if (need_parse) {
+                solver->parse(input.view());
+            }
+            end_phase(0, result.parse_ms);
+        }
+
+        // Answer from the cache, or solve and store
+        auto solve = [&](int part) {
+            if (cached[part - 1]) {return *cached[part - 1];}
+            std::string answer = (part == 1) ? solver->part1() : solver->part2();
+            if (results) {results->put(keys[part - 1], answer);}
+            return answer;
+        };
+        if (options.run_part1) {
+            AOC_TRACE_SCOPE(day_name + " part1", "phase");
+            begin_phase();
+            result.answer1 = solve(1);
+            end_phase(1, result.part1_ms);
+        }
+        if (options.run_part2) {
+            AOC_TRACE_SCOPE(day_name + " part2", "phase");
+            begin_phase();
+            result.answer2 = solve(2);
+            end_phase(2, result.part2_ms);
+        }
+    } catch (const std::exception & e) {
+        result.error = e.what();
+    } catch (const char *e) {
+        result.error = e;
+    }
+
+    return result;
+}
+
+
+/**
+ * Run a task, recording which worker ran it, when it started, how long it took and what it allocated
+ * @param result Task result to fill
+ * @param wall Stopwatch started when scheduling began
+ * @param task The work, returns the answer
+ */
+template <typename F>
+void run_task(TaskResult & result, const runner::Stopwatch & wall, F task) {
+    AOC_TRACE_SCOPE("day" + std::to_string(result.day) + " " + result.phase, "phase");
+    result.worker = common::ThreadPool::worker_index();
+    result.start_ms = wall.elapsed_ms();
+    alloc::Phase phase;
+    try {
+        result.answer = task();
+    } catch (const std::exception & e) {
+        result.error = e.what();
+    } catch (const char *e) {
+        result.error = e;
+    }
+    result.duration_ms = wall.elapsed_ms() - result.start_ms;
+    result.allocs = phase.stop();
+}
+
+
+/**
+ * Run every requested day on a thread pool. Each day's parse is one task, once it
+ * finishes part 1 and part 2 are queued as independent tasks, each on its own copy
+ * of the parsed solver, so days and parts overlap freely.
+ * @param options The run options
+ * @param wall_ms Set to the wall time of the whole run
+ * @param cache Cache of solved answers, or nullptr
+ * @return Result of every task, ordered by day then phase
+ */
+std::vector<TaskResult> run_parallel(const Options & options, double & wall_ms, result_cache::Cache *cache) {
+    // Per-day state shared between that day's tasks
+    struct DayTasks {
+        common::Input input;
+        std::unique_ptr<runner::Solver> solver1, solver2;
+        std::array<TaskResult, 3> results;
+        std::array<result_cache::Key, 2> keys;
+        std::array<std::optional<std::string>, 2> cached;
+    };
+    std::vector<DayTasks> days(options.days.size());
+
+    common::ThreadPool pool(options.jobs);
+    runner::Stopwatch wall;
+    for (std::size_t i = 0; i < options.days.size(); ++i) {
+        DayTasks & state = days[i];
+        int day = options.days[i];
+        state.results = {{{.day = day, .phase = "parse"}, {.day = day, .phase = "part1"}, {.day = day, .phase = "part2"}}};
+
+        pool.submit([&state, &pool, &wall, &options, cache, day]() {
+            run_task(state.results[0], wall, [&]() {
+                const std::string input_path = options.data_dir + "/day" + std::to_string(day) + ".txt";
+                state.input = common::Input::from_file(input_path);
+                if (cache) {
+                    uint64_t hash = model_cache::content_hash(state.input.view());
+                    for (int part = 1; part <= 2; ++part) {
+                        state.keys[part - 1] = {day, part, SOLVER_VERSIONS[day - 1], hash};
+                        bool requested = (part == 1) ? options.run_part1 : options.run_part2;
+                        if (requested) {state.cached[part - 1] = cache->get(state.keys[part - 1]);}
+                    }
+                }
+                bool solve1 = options.run_part1 && !state.cached[0];
+                bool solve2 = options.run_part2 && !state.cached[1];
+                if (!solve1 && !solve2) {return std::string();}
+
+                state.solver1 = FACTORIES[day - 1]();
+                if (options.model_cache) {
+                    state.results[0].cache = state.solver1->parse_cached(state.input.view(), input_path);
+                } else {
+                    state.solver1->parse(state.input.view());
+                }
+                if (solve1 && solve2) {
+                    state.solver2 = state.solver1->clone();
+                }
+                return std::string();
+            });
+            if (!state.results[0].error.empty()) {return;}
+
+            // Answer from the cache, or solve and store
+            auto submit_part = [&state, &pool, &wall, cache](int part) {
+                pool.submit([&state, &wall, cache, part]() {
+                    run_task(state.results[part], wall, [&]() {
+                        if (state.cached[part - 1]) {return *state.cached[part - 1];}
+                        runner::Solver & solver = (part == 2 && state.solver2) ? *state.solver2 : *state.solver1;
+                        std::string answer = (part == 1) ? solver.part1() : solver.part2();
+                        if (cache) {cache->put(state.keys[part - 1], answer);}
+                        return answer;
+                    });
+                });
+            };
+            if (options.run_part1) {submit_part(1);}
+            if (options.run_part2) {submit_part(2);}
+        });
+    }
+    pool.wait();
+    wall_ms = wall.elapsed_ms();
+
+    std::vector<TaskResult> results;
+    for (const auto & state : days) {
+        for (int phase = 0; phase < 3; ++phase) {
+            bool ran = (phase == 0) || (phase == 1 ? options.run_part1 : options.run_part2);
+            if (ran && (phase == 0 || state.results[0].error.empty())) {
+                results.push_back(state.results[phase]);
+            }
+        }
+    }
+    return results;
+}
+
+
+void print_tasks(const std::vector<TaskResult> & results, double wall_ms, std::size_t jobs) {
+    std::cout << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::setw(18) << "Answer"
+              << std::right << std::setw(8) << "Worker" << std::setw(12) << "Start (ms)" << std::setw(12) << "Time (ms)" << std::endl;
+
+    double busy_ms = 0;
+    for (const auto & r : results) {
+        std::cout << std::left << std::setw(5) << r.day << std::setw(7) << r.phase;
+        if (!r.error.empty()) {
+            std::cout << "error: " << r.error << std::endl;
+            continue;
+        }
+        std::cout << std::setw(18) << r.answer << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(8) << r.worker << std::setw(12) << r.start_ms << std::setw(12) << r.duration_ms << std::endl;
+        busy_ms += r.duration_ms;
+    }
+
+    std::cout << std::fixed << std::setprecision(3) << "Wall time " << wall_ms << " ms, task time " << busy_ms
+              << " ms on " << jobs << " threads (" << std::setprecision(2) << busy_ms / wall_ms << "x)" << std::endl;
+}
+
+
+/**
+ * Print the result cache's activity
+ * @param cache The result cache
+ */
+void print_result_cache_summary(const result_cache::Cache & cache) {
+    result_cache::Stats stats = cache.stats();
+    std::cout << "Result cache: " << stats.hits << " hit(s), " << stats.misses << " miss(es), "
+              << stats.stores << " stored, " << stats.evictions << " evicted, "
+              << stats.entries << " entries (" << stats.bytes << " bytes)" << std::endl;
+}
+
+
+/**
+ * Print how many parses were served by the model cache
+ * @param statuses Cache status of each day's parse
+ */
+void print_cache_summary(const std::vector<runner::CacheStatus> & statuses) {
+    auto count = [&](runner::CacheStatus status) {
+        return std::count(statuses.begin(), statuses.end(), status);
+    };
+    std::cout << "Model cache: " << count(runner::CacheStatus::HIT) << " hit(s), "
+              << count(runner::CacheStatus::MISS) << " miss(es), "
+              << count(runner::CacheStatus::NONE) << " day(s) without a cached model" << std::endl;
+}
+
+
+void print_allocs(const std::vector<PhaseAllocs> & allocs) {
+    std::cout << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::right
+              << std::setw(14) << "Allocs" << std::setw(16) << "Bytes" << std::setw(16) << "Peak bytes" << std::endl;
+    for (const auto & a : allocs) {
+        std::cout << std::left << std::setw(5) << a.day << std::setw(7) << a.phase << std::right
+                  << std::setw(14) << a.stats.count << std::setw(16) << a.stats.bytes
+                  << std::setw(16) << a.stats.peak_bytes << std::endl;
+    }
+}
+
+
+/**
+ * Compare the allocations of each phase against its budget
+ * @param allocs Allocations of each phase which ran
+ * @param budgets The budgets, phases without one are unchecked
+ * @return True if every phase is within budget
+ */
+bool check_budgets(const std::vector<PhaseAllocs> & allocs, const std::vector<alloc::Budget> & budgets) {
+    bool ok = true;
+    for (const auto & a : allocs) {
+        for (const auto & b : budgets) {
+            if (b.day != a.day || b.phase != a.phase) {continue;}
+            if (a.stats.count > b.max_count || a.stats.peak_bytes > b.max_peak_bytes) {
+                std::cout << "Over allocation budget: day " << a.day << " " << a.phase
+                          << " allocs " << a.stats.count << " (budget " << b.max_count << ")"
+                          << ", peak bytes " << a.stats.peak_bytes << " (budget " << b.max_peak_bytes << ")" << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+
+/**
+ * Print the allocation table and check the budgets, if tracking is compiled in
+ * @param allocs Allocations of each phase which ran
+ * @param options The run options
+ * @return True if every phase is within budget
+ */
+bool report_allocs(const std::vector<PhaseAllocs> & allocs, const Options & options) {
+    if (!alloc::enabled()) {return true;}
+    std::cout << std::endl;
+    print_allocs(allocs);
+    if (options.alloc_budget_path.empty()) {return true;}
+    return check_budgets(allocs, alloc::read_budgets(options.alloc_budget_path));
+}
+
+
+void print_counters(const std::vector<DayResult> & results, const Options & options) {
+    const char *phase_names[] = {"parse", "part1", "part2"};
+    std::cout << std::endl << std::fixed << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::right
+              << std::setw(16) << "Cycles" << std::setw(16) << "Instructions" << std::setw(7) << "IPC"
+              << std::setw(14) << "L1D misses" << std::setw(14) << "LLC misses" << std::setw(14) << "Br misses" << std::endl;
+    for (const auto & result : results) {
+        if (!result.error.empty()) {continue;}
+        for (int idx = 0; idx < 3; ++idx) {
+            if ((idx == 1 && !options.run_part1) || (idx == 2 && !options.run_part2)) {continue;}
+            const perf::Sample & sample = result.counters[idx];
+            std::cout << std::left << std::setw(5) << result.day << std::setw(7) << phase_names[idx] << std::right;
+            for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+                int width = (event == perf::CYCLES || event == perf::INSTRUCTIONS) ? 16 : 14;
+                std::cout << std::setw(width);
+                if (sample.valid[event]) {
+                    std::cout << std::setprecision(0) << sample.values[event];
+                } else {
+                    std::cout << "-";
+                }
+                if (event == perf::INSTRUCTIONS) {
+                    std::cout << std::setw(7) << std::setprecision(2) << sample.ipc();
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+
+void print_header() {
+    std::cout << std::left << std::setw(5) << "Day" << std::setw(18) << "Part 1" << std::setw(18) << "Part 2"
+              << std::right << std::setw(12) << "Parse (ms)" << std::setw(12) << "P1 (ms)"
+              << std::setw(12) << "P2 (ms)" << std::setw(12) << "Total (ms)" << std::endl;
+}
+
+
+void print_result(const DayResult & result) {
+    std::cout << std::left << std::setw(5) << result.day;
+    if (!result.error.empty()) {
+        std::cout << "error: " << result.error << std::endl;
+        return;
+    }
+    std::cout << std::setw(18) << result.answer1 << std::setw(18) << result.answer2
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << result.parse_ms << std::setw(12) << result.part1_ms
+              << std::setw(12) << result.part2_ms
+              << std::setw(12) << result.parse_ms + result.part1_ms + result.part2_ms << std::endl;
+}
+
+
+/**
+ * Read a baseline file, one "day phase answer ms" entry per line,
+ * blank lines and lines starting with # are ignored
+ * @param path The baseline file
+ * @return The baseline entries
+ */
+std::vector<Baseline> read_baseline(const std::string & path) {
+    std::ifstream in(path);
+    if (!in) {throw std::runtime_error("Cannot open " + path);}
+
+    std::vector<Baseline> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {continue;}
+        std::istringstream iss(line);
+        Baseline entry;
+        if (!(iss >> entry.day >> entry.phase >> entry.answer >> entry.ms)) {
+            throw std::runtime_error("Invalid baseline line: " + line);
+        }
+        baseline.push_back(entry);
+    }
+    return baseline;
+}
+
+
+/**
+ * Run a day a few times, keeping the fastest time of each phase to cut down on noise.
+ * Slow days run once, fast ones up to REPEATS times.
+ * @param day The day to run
+ * @param options The run options
+ * @return The answers and fastest timings
+ */
+DayResult run_day_repeated(int day, const Options & options) {
+    const int REPEATS = 5;
+    const double REPEAT_BUDGET_MS = 2000;
+
+    DayResult best = run_day(day, options, nullptr);
+    double total_ms = best.parse_ms + best.part1_ms + best.part2_ms;
+    for (int i = 1; i < REPEATS && best.error.empty() && total_ms < REPEAT_BUDGET_MS; ++i) {
+        DayResult result = run_day(day, options, nullptr);
+        if (result.answer1 != best.answer1 || result.answer2 != best.answer2) {
+            best.error = "answers differ between runs";
+            break;
+        }
+        best.parse_ms = std::min(best.parse_ms, result.parse_ms);
+        best.part1_ms = std::min(best.part1_ms, result.part1_ms);
+        best.part2_ms = std::min(best.part2_ms, result.part2_ms);
+        total_ms += result.parse_ms + result.part1_ms + result.part2_ms;
+    }
+    return best;
+}
+
+
+/**
+ * Run every requested day and write its answers and times as the new baseline
+ * @param options The run options
+ * @return Exit status
+ */
+int write_baseline(const Options & options) {
+    std::ofstream out(options.write_baseline_path);
+    out << "# Known answers and fastest of up to 5 runs in ms, checked by `aoc --check` (make check_regression)\n"
+        << "# day phase answer ms, parse has no answer (-). Regenerate with `aoc --write-baseline FILE`\n"
+        << std::fixed << std::setprecision(3);
+    for (const auto & day : options.days) {
+        DayResult result = run_day_repeated(day, options);
+        if (!result.error.empty()) {
+            std::cerr << "Day " << day << " failed: " << result.error << std::endl;
+            return EXIT_FAILURE;
+        }
+        out << day << " parse - " << result.parse_ms << "\n"
+            << day << " part1 " << result.answer1 << " " << result.part1_ms << "\n"
+            << day << " part2 " << result.answer2 << " " << result.part2_ms << "\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * Run every requested day and diff its answers and times against the baseline. A phase
+ * regresses if it's slower than the tolerance allows and by more than MIN_REGRESSION_MS,
+ * so sub-millisecond jitter on the fast days isn't reported.
+ * @param options The run options
+ * @return Exit status, failure on any wrong answer, error or slowdown
+ */
+int check_baseline(const Options & options) {
+    const double MIN_REGRESSION_MS = 0.5;
+    std::vector<Baseline> baseline = read_baseline(options.check_path);
+
+    std::cout << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::setw(18) << "Expected"
+              << std::setw(18) << "Actual" << std::right << std::setw(12) << "Base (ms)" << std::setw(12) << "Now (ms)"
+              << std::setw(9) << "Delta %" << "  Status" << std::endl;
+
+    int failures = 0;
+    for (const auto & day : options.days) {
+        DayResult result = run_day_repeated(day, options);
+        const std::array<std::string, 3> answers = {"-", result.answer1, result.answer2};
+        const std::array<double, 3> times = {result.parse_ms, result.part1_ms, result.part2_ms};
+        const std::array<const char *, 3> phases = {"parse", "part1", "part2"};
+
+        if (!result.error.empty()) {
+            std::cout << std::left << std::setw(5) << day << "error: " << result.error << std::endl;
+            ++failures;
+            continue;
+        }
+        for (int idx = 0; idx < 3; ++idx) {
+            if ((idx == 1 && !options.run_part1) || (idx == 2 && !options.run_part2)) {continue;}
+            auto entry = std::find_if(baseline.begin(), baseline.end(), [&](const Baseline & b) {
+                return b.day == day && b.phase == phases[idx];
+            });
+
+            std::string status = "new";
+            std::string expected = "?";
+            double base_ms = 0, delta_pct = 0;
+            if (entry != baseline.end()) {
+                expected = entry->answer;
+                base_ms = entry->ms;
+                delta_pct = (base_ms > 0) ? 100 * (times[idx] - base_ms) / base_ms : 0;
+                bool slower = delta_pct > options.tolerance_pct && times[idx] - base_ms > MIN_REGRESSION_MS;
+                if (expected != answers[idx]) {
+                    status = "WRONG";
+                } else if (slower) {
+                    status = "SLOWER";
+                } else {
+                    status = "ok";
+                }
+            }
+            failures += (status == "WRONG" || status == "SLOWER");
+
+            std::cout << std::left << std::setw(5) << day << std::setw(7) << phases[idx] << std::setw(18) << expected
+                      << std::setw(18) << answers[idx] << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(12) << base_ms << std::setw(12) << times[idx]
+                      << std::setprecision(1) << std::setw(9) << delta_pct << "  " << status << std::endl;
+        }
+    }
+
+    std::cout << (failures ? std::to_string(failures) + " regression(s)" : std::string("No regressions"))
+              << " (tolerance " << options.tolerance_pct << "%)" << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!options.alloc_budget_path.empty() && !alloc::enabled()) {
+        std::cerr << "Allocation budgets need a build with -DAOC_ALLOC_TRACKING=ON" << std::endl;
+        return 1;
+    }
+
+    // Regression checking against a baseline
+    try {
+        if (!options.write_baseline_path.empty()) {return write_baseline(options);}
+        if (!options.check_path.empty()) {return check_baseline(options);}
+    } catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Hardware counters are per thread, so only in sequential mode
+    std::unique_ptr<perf::Counters> counters;
+    if (options.perf && options.jobs >= 0) {
+        std::cerr << "Warning: --perf is ignored with --jobs" << std::endl;
+    } else if (options.perf) {
+        counters = std::make_unique<perf::Counters>();
+        if (!counters->available()) {
+            std::cerr << "Warning: hardware counters unavailable (" << counters->error() << "), reporting times only" << std::endl;
+            counters.reset();
+        }
+    }
+
+    // Solved answers, only outside the baseline modes so those always measure the solvers
+    std::unique_ptr<result_cache::Cache> results_cache;
+    if (!options.result_cache_dir.empty()) {
+        try {
+            results_cache = std::make_unique<result_cache::Cache>(options.result_cache_dir,
+                                                                  static_cast<uint64_t>(options.result_cache_mb) << 20);
+        } catch (const std::exception & e) {
+            std::cerr << "Cannot open result cache: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Parallel mode
+    if (options.jobs >= 0) {
+        if (options.jobs == 0) {
+            options.jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+        double wall_ms = 0;
+        std::vector<TaskResult> results = run_parallel(options, wall_ms, results_cache.get());
+        print_tasks(results, wall_ms, options.jobs);
+        if (results_cache) {print_result_cache_summary(*results_cache);}
+        if (options.model_cache) {
+            std::vector<runner::CacheStatus> statuses;
+            for (const auto & r : results) {
+                if (r.phase == std::string("parse") && r.error.empty()) {statuses.push_back(r.cache);}
+            }
+            print_cache_summary(statuses);
+        }
+        bool has_error = std::any_of(results.begin(), results.end(), [](const TaskResult & r) { return !r.error.empty(); });
+
+        std::vector<PhaseAllocs> allocs;
+        for (const auto & r : results) {
+            allocs.push_back({r.day, r.phase, r.allocs});
+        }
+        has_error |= !report_allocs(allocs, options);
+        return has_error ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    print_header();
+    double parse_total = 0, part1_total = 0, part2_total = 0;
+    bool has_error = false;
+    std::vector<PhaseAllocs> allocs;
+    std::vector<DayResult> results;
+    std::vector<runner::CacheStatus> statuses;
+    for (const auto & day : options.days) {
+        DayResult result = run_day(day, options, counters.get(), results_cache.get());
+        print_result(result);
+        if (result.error.empty()) {
+            allocs.push_back({day, "parse", result.allocs[0]});
+            if (options.run_part1) {allocs.push_back({day, "part1", result.allocs[1]});}
+            if (options.run_part2) {allocs.push_back({day, "part2", result.allocs[2]});}
+            statuses.push_back(result.cache);
+        }
+        parse_total += result.parse_ms;
+        part1_total += result.part1_ms;
+        part2_total += result.part2_ms;
+        has_error |= !result.error.empty();
+        results.push_back(result);
+    }
+
+    std::cout << std::left << std::setw(41) << "Total" << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << parse_total << std::setw(12) << part1_total << std::setw(12) << part2_total
+              << std::setw(12) << parse_total + part1_total + part2_total << std::endl;
+
+    if (options.model_cache) {print_cache_summary(statuses);}
+    if (results_cache) {print_result_cache_summary(*results_cache);}
+    if (counters) {print_counters(results, options);}
+    has_error |= !report_allocs(allocs, options);
+    return has_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,547 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>              // strerror
+#include <csignal>
+#include <unistd.h>             // read, write, close, unlink, pipe2
+#include <fcntl.h>              // O_CLOEXEC, O_NONBLOCK
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "common.h"
+#include "runner.h"
+#include "days.h"
+#include "thread_pool.h"
+#include "instrument.h"
+
+
+/**
+ * Solver daemon: keeps every day loaded and answers requests over a Unix domain socket.
+ *
+ * A connection carries any number of requests, each answered in order:
+ *   request   "<day> <parts> <size>\n" then <size> bytes of input, parts is 1, 2 or 12
+ *   response  "ok <day> <answer1> <answer2> <parse_ms> <part1_ms> <part2_ms>\n"
+ *             (a part which wasn't requested is "-"), or "error <message>\n"
+ * An event loop on the main thread reads every connection and queues each complete request
+ * on a worker pool, so requests are answered concurrently and an idle connection holds no
+ * worker. A connection isn't read while its request is on the pool, which keeps its
+ * responses in order. Each worker keeps its own solvers, so repeated requests reuse their
+ * allocations.
+ */
+
+// consts
+const char DEFAULT_SOCKET[] = "/tmp/aocd.sock";
+const std::size_t MAX_INPUT_SIZE = 64 << 20;
+const std::size_t MAX_HEADER_SIZE = 64;
+const int LISTEN_BACKLOG = 64;
+const std::size_t READ_CHUNK = 1 << 16;
+
+// Command line options
+struct Options {
+    std::string socket_path = DEFAULT_SOCKET;
+    int jobs = 0;
+    int send_day = 0;                   // Client mode if set
+    std::string send_parts = "12";
+};
+
+std::atomic<bool> stopping{false};
+// Write end of the event loop's wake pipe, for the signal handler and finished requests
+int wake_fd = -1;
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " [options]" << std::endl
+              << "  -s, --socket PATH  Socket to listen on or connect to (default: " << DEFAULT_SOCKET << ")" << std::endl
+              << "  -j, --jobs N       Worker threads solving requests (default: one per core)" << std::endl
+              << "  --send DAY         Client mode, solve stdin as DAY's input and print the response" << std::endl
+              << "  -p, --part N       With --send, only solve part N (1 or 2)" << std::endl
+              << "  -h, --help         Show this message" << std::endl;
+}
+
+
+/**
+ * Parse the command line
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Options to fill
+ * @return True if the command line is valid
+ */
+bool parse_args(int argc, char **argv, Options & options) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                exit(0);
+            } else if ((arg == "-s" || arg == "--socket") && has_value) {
+                options.socket_path = argv[++i];
+            } else if ((arg == "-j" || arg == "--jobs") && has_value) {
+                options.jobs = common::to_number<int>(argv[++i]);
+            } else if (arg == "--send" && has_value) {
+                options.send_day = common::to_number<int>(argv[++i]);
+                if (options.send_day < 1 || options.send_day > static_cast<int>(FACTORIES.size())) {return false;}
+            } else if ((arg == "-p" || arg == "--part") && has_value) {
+                options.send_parts = argv[++i];
+                if (options.send_parts != "1" && options.send_parts != "2") {return false;}
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    return options.socket_path.size() < sizeof(sockaddr_un::sun_path);
+}
+
+
+/**
+ * Write all of the data to a socket
+ * @param fd The socket
+ * @param data The data
+ * @param flags send() flags, e.g. MSG_DONTWAIT to fail rather than block
+ * @return False if the socket broke
+ */
+bool send_all(int fd, std::string_view data, int flags = 0) {
+    while (!data.empty()) {
+        ssize_t n = send(fd, data.data(), data.size(), flags | MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {continue;}
+        if (n <= 0) {return false;}
+        data.remove_prefix(n);
+    }
+    return true;
+}
+
+
+/**
+ * Client side of a connection, buffered line reads and full writes
+ */
+class Connection {
+public:
+    explicit Connection(int fd) : fd(fd) {}
+
+    Connection(const Connection &) = delete;
+    Connection & operator=(const Connection &) = delete;
+
+    ~Connection() {
+        close(fd);
+    }
+
+    /**
+     * Read up to and excluding the next newline
+     * @param line Set to the line
+     * @param max_size Longest line accepted
+     * @return False on end of stream, error or an overlong line
+     */
+    bool read_line(std::string & line, std::size_t max_size) {
+        while (true) {
+            std::size_t newline = buffer.find('\n', start);
+            if (newline != std::string::npos) {
+                line.assign(buffer, start, newline - start);
+                start = newline + 1;
+                return true;
+            }
+            if (buffer.size() - start > max_size || !fill()) {return false;}
+        }
+    }
+
+    bool write_all(std::string_view data) {
+        return send_all(fd, data);
+    }
+
+private:
+    int fd;
+    std::string buffer;
+    std::size_t start = 0;
+
+    bool fill() {
+        if (start == buffer.size()) {
+            buffer.clear();
+            start = 0;
+        }
+        char chunk[READ_CHUNK];
+        while (true) {
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {continue;}
+            if (n <= 0) {return false;}
+            buffer.append(chunk, n);
+            return true;
+        }
+    }
+};
+
+
+// A request taken off a connection, solved on the pool
+struct Request {
+    int day = 0;
+    std::string parts;
+    std::string input;
+};
+
+// Outcome of taking a request from a connection's received bytes
+enum class Take {
+    INCOMPLETE,         // Wait for more bytes
+    READY,              // A whole request was taken
+    INVALID,            // The request was taken and answered with an error
+    REFUSED,            // Answer with an error and close the connection
+    BROKEN              // Overlong header, close the connection
+};
+
+
+/**
+ * Take the next request from the bytes received on a connection
+ * @param buffer Received bytes, the request is removed from the front
+ * @param request Set to the request if READY
+ * @param response Set to the error response if INVALID or REFUSED
+ * @return What was taken
+ */
+Take take_request(std::string & buffer, Request & request, std::string & response) {
+    std::size_t newline = buffer.find('\n');
+    if (newline == std::string::npos) {
+        return buffer.size() > MAX_HEADER_SIZE ? Take::BROKEN : Take::INCOMPLETE;
+    }
+    if (newline > MAX_HEADER_SIZE) {return Take::BROKEN;}
+
+    std::istringstream iss(buffer.substr(0, newline));
+    std::size_t size = 0;
+    if (!(iss >> request.day >> request.parts >> size)) {
+        // Without a size the body can't be skipped, the next line is read as a header
+        buffer.erase(0, newline + 1);
+        response = "error invalid request\n";
+        return Take::INVALID;
+    }
+    if (size > MAX_INPUT_SIZE) {
+        response = "error input too large\n";
+        return Take::REFUSED;
+    }
+
+    // The body is taken even for an invalid request, so it isn't read as headers
+    if (buffer.size() - (newline + 1) < size) {return Take::INCOMPLETE;}
+    bool valid = request.day >= 1 && request.day <= static_cast<int>(FACTORIES.size())
+                 && (request.parts == "1" || request.parts == "2" || request.parts == "12");
+    if (valid) {request.input.assign(buffer, newline + 1, size);}
+    buffer.erase(0, newline + 1 + size);
+    if (!valid) {
+        response = "error invalid request\n";
+        return Take::INVALID;
+    }
+    return Take::READY;
+}
+
+
+// Per-worker state, reused across the requests the worker serves
+struct Worker {
+    std::vector<std::unique_ptr<runner::Solver>> solvers;
+
+    Worker() {
+        for (const auto & factory : FACTORIES) {
+            solvers.push_back(factory());
+        }
+    }
+};
+
+Worker & worker() {
+    static thread_local Worker w;
+    return w;
+}
+
+
+/**
+ * Solve a single request
+ * @param request The request
+ * @return The response line
+ */
+std::string handle_request(const Request & request) {
+    AOC_COUNT("aocd.requests", 1);
+    Worker & w = worker();
+
+    AOC_TRACE_SCOPE("aocd day" + std::to_string(request.day), "request");
+    runner::Solver & solver = *w.solvers[request.day - 1];
+    std::string answer1 = "-", answer2 = "-";
+    double parse_ms = 0, part1_ms = 0, part2_ms = 0;
+    try {
+        runner::Stopwatch stopwatch;
+        solver.parse(request.input);
+        parse_ms = stopwatch.elapsed_ms();
+        if (request.parts.find('1') != std::string::npos) {
+            stopwatch.reset();
+            answer1 = solver.part1();
+            part1_ms = stopwatch.elapsed_ms();
+        }
+        if (request.parts.find('2') != std::string::npos) {
+            stopwatch.reset();
+            answer2 = solver.part2();
+            part2_ms = stopwatch.elapsed_ms();
+        }
+    } catch (const std::exception & e) {
+        return std::string("error ") + e.what() + "\n";
+    } catch (const char *e) {
+        return std::string("error ") + e + "\n";
+    }
+
+    std::ostringstream response;
+    response << "ok " << request.day << " " << answer1 << " " << answer2 << std::fixed << std::setprecision(3)
+             << " " << parse_ms << " " << part1_ms << " " << part2_ms << "\n";
+    return response.str();
+}
+
+
+// Wake the event loop, safe from a signal handler
+void wake_loop() {
+    int saved_errno = errno;
+    ssize_t n = write(wake_fd, "w", 1);
+    (void) n;               // A full pipe wakes the loop all the same
+    errno = saved_errno;
+}
+
+
+/**
+ * Connections whose requests the pool has answered, handed back to the event loop
+ */
+class Completions {
+public:
+    // Connection and whether its response was written
+    typedef std::pair<int, bool> Completion;
+
+    void push(int fd, bool written) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.emplace_back(fd, written);
+        }
+        wake_loop();
+    }
+
+    std::vector<Completion> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Completion> result;
+        result.swap(done);
+        return result;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<Completion> done;
+};
+
+
+// A connection served by the event loop, closed when erased
+struct Client {
+    int fd;
+    std::string buffer;         // Received bytes not yet taken as a request
+    bool busy = false;          // A request is on the pool, the socket isn't read until it's answered
+
+    explicit Client(int fd) : fd(fd) {}
+    Client(const Client &) = delete;
+    Client & operator=(const Client &) = delete;
+    ~Client() {
+        close(fd);
+    }
+};
+
+
+/**
+ * Read what a client sent, without blocking
+ * @param client The client
+ * @return False if the client closed the connection or it broke
+ */
+bool receive(Client & client) {
+    char chunk[READ_CHUNK];
+    ssize_t n = recv(client.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (n < 0) {return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;}
+    if (n == 0) {return false;}
+    client.buffer.append(chunk, n);
+    return true;
+}
+
+
+/**
+ * Queue a client's next complete request on the pool, invalid ones are answered right away
+ * @param client The client, busy once a request is queued
+ * @param pool The worker pool
+ * @param completions Where the worker reports the request answered
+ * @return False if the connection is broken and should be closed
+ */
+bool dispatch(Client & client, common::ThreadPool & pool, Completions & completions) {
+    Request request;
+    std::string response;
+    while (!client.busy) {
+        switch (take_request(client.buffer, request, response)) {
+            case Take::INCOMPLETE:
+                return true;
+            case Take::BROKEN:
+                return false;
+            case Take::INVALID:
+                // Never blocks the loop, a client that doesn't read its errors is dropped
+                if (!send_all(client.fd, response, MSG_DONTWAIT)) {return false;}
+                break;
+            case Take::REFUSED:
+                send_all(client.fd, response, MSG_DONTWAIT);
+                return false;
+            case Take::READY: {
+                client.busy = true;
+                int fd = client.fd;
+                pool.submit([fd, request = std::move(request), &completions]() {
+                    // Queued requests are dropped on shutdown
+                    std::string reply = stopping ? "" : handle_request(request);
+                    completions.push(fd, !reply.empty() && send_all(fd, reply));
+                });
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+
+void handle_signal(int) {
+    stopping = true;
+    wake_loop();
+}
+
+
+/**
+ * Listen on the socket and serve every connection from an event loop, until SIGINT/SIGTERM
+ * @param options The daemon options
+ * @return Exit code
+ */
+int run_server(const Options & options) {
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listen_fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, options.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(options.socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || listen(listen_fd, LISTEN_BACKLOG) < 0) {
+        std::cerr << "Cannot listen on " << options.socket_path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return EXIT_FAILURE;
+    }
+
+    int wake[2];
+    if (pipe2(wake, O_CLOEXEC | O_NONBLOCK) < 0) {
+        std::cerr << "pipe: " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return EXIT_FAILURE;
+    }
+    wake_fd = wake[1];
+
+    // The handler also wakes the loop, so a signal is never missed between two polls
+    struct sigaction action{};
+    action.sa_handler = handle_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    {
+        std::unordered_map<int, Client> clients;
+        Completions completions;
+        // Declared last, so the workers are done before the clients are closed
+        common::ThreadPool pool(options.jobs);
+        std::cerr << "aocd listening on " << options.socket_path << " with " << pool.size() << " worker(s)" << std::endl;
+
+        std::vector<pollfd> polled;
+        while (!stopping) {
+            polled.assign({{listen_fd, POLLIN, 0}, {wake[0], POLLIN, 0}});
+            for (const auto & [fd, client] : clients) {
+                if (!client.busy) {polled.push_back({fd, POLLIN, 0});}
+            }
+            if (poll(polled.data(), polled.size(), -1) < 0) {
+                if (errno == EINTR) {continue;}
+                std::cerr << "poll: " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            // Read the clients, a request is queued as soon as it's complete
+            for (std::size_t i = 2; i < polled.size(); ++i) {
+                if (polled[i].revents == 0) {continue;}
+                Client & client = clients.at(polled[i].fd);
+                if (!receive(client) || !dispatch(client, pool, completions)) {clients.erase(polled[i].fd);}
+            }
+
+            // Answered clients are read again, starting with requests they already sent
+            if (polled[1].revents != 0) {
+                char drain[64];
+                while (read(wake[0], drain, sizeof(drain)) > 0) {}
+                for (const auto & [fd, written] : completions.take()) {
+                    Client & client = clients.at(fd);
+                    client.busy = false;
+                    if (!written || !dispatch(client, pool, completions)) {clients.erase(fd);}
+                }
+            }
+
+            if (polled[0].revents != 0) {
+                int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (fd >= 0) {
+                    clients.try_emplace(fd, fd);
+                } else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) {
+                    std::cerr << "accept: " << std::strerror(errno) << std::endl;
+                    break;
+                }
+            }
+        }
+
+        // Unblock workers writing to clients, queued requests are dropped
+        stopping = true;
+        for (const auto & [fd, client] : clients) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+    wake_fd = -1;
+    close(wake[0]);
+    close(wake[1]);
+    close(listen_fd);
+    unlink(options.socket_path.c_str());
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * Send stdin as a single request and print the response
+ * @param options The client options
+ * @return Exit code, failure if the daemon answered with an error
+ */
+int run_client(const Options & options) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, options.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Cannot connect to " << options.socket_path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) {close(fd);}
+        return EXIT_FAILURE;
+    }
+
+    Connection conn(fd);
+    common::Input input = common::Input::from_stdin();
+    std::string header = std::to_string(options.send_day) + " " + options.send_parts + " " + std::to_string(input.size()) + "\n";
+    std::string response;
+    if (!conn.write_all(header) || !conn.write_all(input.view()) || !conn.read_line(response, MAX_INPUT_SIZE)) {
+        std::cerr << "Connection to " << options.socket_path << " failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << response << std::endl;
+    return response.compare(0, 3, "ok ") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    return options.send_day ? run_client(options) : run_server(options);
+}
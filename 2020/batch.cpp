@@ -0,0 +1,361 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <algorithm>            // sort
+#include <cctype>               // isdigit
+#include <filesystem>
+
+#include "common.h"
+#include "runner.h"
+#include "days.h"
+#include "work_stealing_pool.h"
+
+
+/**
+ * Batch runner: solves a directory or manifest of inputs, each tagged with its day,
+ * in one process across every core.
+ *
+ * A directory is searched recursively for .txt files, tagged by the "dayN" their name
+ * starts with (day7.txt, day7-alice.txt) or else by their parent directory (day7/alice.txt).
+ * A manifest lists "<day> <path>" per line, paths relative to the manifest, # starts a comment.
+ */
+
+// consts
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+
+// Command line options
+struct Options {
+    std::string input;
+    int jobs = 0;
+    bool part1 = true, part2 = true;
+    std::string json_path, csv_path;
+};
+
+// An input to solve
+struct Task {
+    int day;
+    std::string path;
+};
+
+// Outcome of solving one input
+struct BatchResult {
+    int day;
+    std::string path;
+    std::size_t bytes = 0;
+    std::string answer1, answer2;
+    double parse_ms = 0, part1_ms = 0, part2_ms = 0;
+    std::string error;
+};
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " [options] DIR|MANIFEST" << std::endl
+              << "  DIR                Directory searched for dayN*.txt and dayN/*.txt inputs" << std::endl
+              << "  MANIFEST           File listing \"<day> <path>\" per line" << std::endl
+              << "  -j, --jobs N       Worker threads (default: one per core)" << std::endl
+              << "  -p, --part N       Only solve part N (1 or 2)" << std::endl
+              << "  --json FILE        Write the results as JSON" << std::endl
+              << "  --csv FILE         Write the results as CSV" << std::endl
+              << "  -h, --help         Show this message" << std::endl;
+}
+
+
+/**
+ * Parse the command line
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Options to fill
+ * @return True if the command line is valid
+ */
+bool parse_args(int argc, char **argv, Options & options) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                exit(0);
+            } else if ((arg == "-j" || arg == "--jobs") && has_value) {
+                options.jobs = common::to_number<int>(argv[++i]);
+            } else if ((arg == "-p" || arg == "--part") && has_value) {
+                int part = common::to_number<int>(argv[++i]);
+                if (part != 1 && part != 2) {return false;}
+                options.part1 = part == 1;
+                options.part2 = part == 2;
+            } else if (arg == "--json" && has_value) {
+                options.json_path = argv[++i];
+            } else if (arg == "--csv" && has_value) {
+                options.csv_path = argv[++i];
+            } else if (options.input.empty() && arg[0] != '-') {
+                options.input = arg;
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    return !options.input.empty();
+}
+
+
+/**
+ * Day a name is tagged with
+ * @param name A file or directory name, e.g. "day7-alice.txt"
+ * @return The day, or 0 if the name doesn't start with a valid "dayN"
+ */
+int day_from_name(std::string_view name) {
+    if (name.substr(0, 3) != "day") {return 0;}
+    std::size_t end = 3;
+    while (end < name.size() && std::isdigit(static_cast<unsigned char>(name[end]))) {++end;}
+    if (end == 3 || end - 3 > 2) {return 0;}
+    int day = common::to_number<int>(name.substr(3, end - 3));
+    return day <= static_cast<int>(FACTORIES.size()) ? day : 0;
+}
+
+
+/**
+ * Collect the .txt inputs below a directory
+ * @param dir The directory
+ * @param skipped Incremented for every .txt file without a day tag
+ * @return The tagged inputs, sorted by path
+ */
+std::vector<Task> scan_directory(const std::filesystem::path & dir, int & skipped) {
+    std::vector<Task> tasks;
+    for (const auto & entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".txt") {continue;}
+        int day = day_from_name(entry.path().filename().string());
+        if (day == 0) {day = day_from_name(entry.path().parent_path().filename().string());}
+        if (day == 0) {
+            ++skipped;
+            continue;
+        }
+        tasks.push_back({day, entry.path().string()});
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const Task & a, const Task & b) { return a.path < b.path; });
+    return tasks;
+}
+
+
+/**
+ * Read a manifest of "<day> <path>" lines
+ * @param path The manifest
+ * @return The listed inputs, in order
+ * @throws std::runtime_error on a malformed line
+ */
+std::vector<Task> read_manifest(const std::filesystem::path & path) {
+    std::vector<Task> tasks;
+    common::Input manifest = common::Input::from_file(path.string());
+    int line_number = 0;
+    for (const auto & line : common::split_lines(manifest.view())) {
+        ++line_number;
+        std::istringstream iss{std::string(line.substr(0, line.find('#')))};
+        Task task;
+        if (!(iss >> task.day)) {continue;}
+        std::getline(iss >> std::ws, task.path);
+        if (task.day < 1 || task.day > static_cast<int>(FACTORIES.size()) || task.path.empty()) {
+            throw std::runtime_error(path.string() + ":" + std::to_string(line_number) + ": expected \"<day> <path>\"");
+        }
+        if (std::filesystem::path(task.path).is_relative()) {
+            task.path = (path.parent_path() / task.path).string();
+        }
+        tasks.push_back(task);
+    }
+    return tasks;
+}
+
+
+/**
+ * Solve a single input on the calling worker, with its own solvers
+ * @param task The input
+ * @param options Which parts to solve
+ * @return The answers and timings, or the error
+ */
+BatchResult solve(const Task & task, const Options & options) {
+    static thread_local std::vector<std::unique_ptr<runner::Solver>> solvers;
+    if (solvers.empty()) {
+        for (const auto & factory : FACTORIES) {
+            solvers.push_back(factory());
+        }
+    }
+
+    BatchResult result;
+    result.day = task.day;
+    result.path = task.path;
+    try {
+        common::Input input = common::Input::from_file(task.path);
+        result.bytes = input.size();
+        runner::Solver & solver = *solvers[task.day - 1];
+
+        runner::Stopwatch stopwatch;
+        solver.parse(input.view());
+        result.parse_ms = stopwatch.elapsed_ms();
+        if (options.part1) {
+            stopwatch.reset();
+            result.answer1 = solver.part1();
+            result.part1_ms = stopwatch.elapsed_ms();
+        }
+        if (options.part2) {
+            stopwatch.reset();
+            result.answer2 = solver.part2();
+            result.part2_ms = stopwatch.elapsed_ms();
+        }
+    } catch (const std::exception & e) {
+        result.error = e.what();
+    } catch (const char *e) {
+        result.error = e;
+    }
+    return result;
+}
+
+
+// Quote a CSV field if it needs it
+std::string csv_field(const std::string & s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {return s;}
+    std::string quoted = "\"";
+    for (char c : s) {
+        quoted += c;
+        if (c == '"') {quoted += '"';}
+    }
+    return quoted + "\"";
+}
+
+std::string json_string(const std::string & s) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+
+void write_json(const std::string & path, const std::vector<BatchResult> & results, double wall_s, std::size_t bytes) {
+    std::ofstream out(path);
+    out << std::setprecision(6) << "{\n  \"inputs\": " << results.size() << ",\n  \"bytes\": " << bytes
+        << ",\n  \"wall_s\": " << wall_s << ",\n  \"inputs_per_s\": " << results.size() / wall_s
+        << ",\n  \"mb_per_s\": " << bytes / BYTES_PER_MB / wall_s << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BatchResult & r = results[i];
+        out << (i ? "," : "") << "\n    {\"day\": " << r.day << ", \"path\": " << json_string(r.path) << ", \"bytes\": " << r.bytes;
+        if (!r.error.empty()) {
+            out << ", \"error\": " << json_string(r.error) << "}";
+            continue;
+        }
+        if (!r.answer1.empty()) {out << ", \"part1\": " << json_string(r.answer1);}
+        if (!r.answer2.empty()) {out << ", \"part2\": " << json_string(r.answer2);}
+        out << ", \"parse_ms\": " << r.parse_ms << ", \"part1_ms\": " << r.part1_ms << ", \"part2_ms\": " << r.part2_ms << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+
+void write_csv(const std::string & path, const std::vector<BatchResult> & results) {
+    std::ofstream out(path);
+    out << std::setprecision(6) << "day,path,bytes,part1,part2,parse_ms,part1_ms,part2_ms,error\n";
+    for (const auto & r : results) {
+        out << r.day << "," << csv_field(r.path) << "," << r.bytes << "," << csv_field(r.answer1) << ","
+            << csv_field(r.answer2) << "," << r.parse_ms << "," << r.part1_ms << "," << r.part2_ms << ","
+            << csv_field(r.error) << "\n";
+    }
+}
+
+
+/**
+ * Print per day totals and the overall throughput
+ * @param results Every input's result
+ * @param wall_s Wall time of the whole batch
+ * @param bytes Total input size
+ * @param threads Worker threads used
+ * @param steals Tasks taken from another worker's queue
+ */
+void print_summary(const std::vector<BatchResult> & results, double wall_s, std::size_t bytes, std::size_t threads, std::size_t steals) {
+    std::vector<int> inputs(FACTORIES.size() + 1, 0), errors(FACTORIES.size() + 1, 0);
+    std::vector<double> cpu_ms(FACTORIES.size() + 1, 0);
+    int total_errors = 0;
+    for (const auto & r : results) {
+        ++inputs[r.day];
+        cpu_ms[r.day] += r.parse_ms + r.part1_ms + r.part2_ms;
+        if (!r.error.empty()) {
+            ++errors[r.day];
+            ++total_errors;
+            std::cerr << r.path << ": " << r.error << std::endl;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3)
+              << std::left << std::setw(5) << "Day" << std::right << std::setw(8) << "Inputs" << std::setw(8) << "Errors"
+              << std::setw(14) << "Mean (ms)" << std::endl;
+    for (std::size_t day = 1; day < inputs.size(); ++day) {
+        if (!inputs[day]) {continue;}
+        std::cout << std::left << std::setw(5) << day << std::right << std::setw(8) << inputs[day] << std::setw(8) << errors[day]
+                  << std::setw(14) << cpu_ms[day] / inputs[day] << std::endl;
+    }
+    std::cout << std::endl
+              << results.size() << " input(s), " << total_errors << " error(s), " << bytes / BYTES_PER_MB << " MB in "
+              << wall_s << " s on " << threads << " thread(s), " << steals << " steal(s)" << std::endl
+              << std::setprecision(1) << results.size() / wall_s << " inputs/s, "
+              << std::setprecision(3) << bytes / BYTES_PER_MB / wall_s << " MB/s" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Task> tasks;
+    int skipped = 0;
+    try {
+        tasks = std::filesystem::is_directory(options.input)
+            ? scan_directory(options.input, skipped)
+            : read_manifest(options.input);
+    } catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (skipped) {
+        std::cerr << "Skipped " << skipped << " .txt file(s) not tagged with a day" << std::endl;
+    }
+
+    // Each task writes only its own slot
+    std::vector<BatchResult> results(tasks.size());
+    runner::Stopwatch wall;
+    std::size_t threads, steals;
+    {
+        common::WorkStealingPool pool(options.jobs);
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            pool.submit([&, i]() { results[i] = solve(tasks[i], options); });
+        }
+        pool.wait();
+        threads = pool.size();
+        steals = pool.steals();
+    }
+    double wall_s = std::max(wall.elapsed_ms(), 1e-3) / 1000.0;
+
+    std::size_t bytes = 0;
+    bool has_error = false;
+    for (const auto & r : results) {
+        bytes += r.bytes;
+        has_error |= !r.error.empty();
+    }
+    print_summary(results, wall_s, bytes, threads, steals);
+    if (!options.json_path.empty()) {write_json(options.json_path, results, wall_s, bytes);}
+    if (!options.csv_path.empty()) {write_csv(options.csv_path, results);}
+
+    return has_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,389 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <algorithm>            // sort, min
+#include <cmath>                // sqrt, floor
+#include <cstdlib>
+#include <sched.h>              // sched_setaffinity, sched_getcpu
+
+#include "common.h"
+#include "runner.h"
+#include "days.h"
+#include "perf_counters.h"
+
+
+// consts
+const char *PHASE_NAMES[] = {"parse", "part1", "part2"};
+const int NUM_PHASES = 3;
+
+// Command line options
+struct Options {
+    std::vector<int> days;
+    int iterations = 30;
+    int warmup = 3;
+    int min_iterations = 5;
+    int budget_s = 10;
+    int cpu = -1;
+    std::string data_dir = AOC_DATA_DIR;
+    std::string json_path, csv_path;
+    bool perf = false;
+    bool model_cache = false;
+};
+
+// Summary statistics of a set of timing samples, in ms
+struct Summary {
+    double min = 0, median = 0, mean = 0, p99 = 0, stddev = 0;
+    std::size_t samples = 0, outliers = 0;
+};
+
+// Benchmark results for a single day
+struct DayBench {
+    int day = 0;
+    std::array<Summary, NUM_PHASES> phases{};
+    std::array<perf::Sample, NUM_PHASES> counters{};   // Mean per measured iteration
+    std::string error{};
+};
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " [options] [days...]" << std::endl
+              << "  days                 Days to run, e.g. 1 5 7-9 (default: all)" << std::endl
+              << "  -n, --iterations N   Measured iterations per day (default: 30)" << std::endl
+              << "  -w, --warmup N       Unmeasured warmup iterations per day (default: 3)" << std::endl
+              << "  -b, --budget SEC     Stop measuring a day after SEC seconds, once 5 samples exist (default: 10)" << std::endl
+              << "  -c, --cpu N          Pin to CPU N (default: the CPU the process starts on)" << std::endl
+              << "  -d, --data DIR       Directory holding the dayN.txt inputs (default: " << AOC_DATA_DIR << ")" << std::endl
+              << "  --perf               Also report hardware counters, mean per iteration" << std::endl
+              << "  --model-cache        Parse through the binary model cache, the warmup writes it" << std::endl
+              << "  --json FILE          Write the results as JSON" << std::endl
+              << "  --csv FILE           Write the results as CSV" << std::endl
+              << "  -h, --help           Show this message" << std::endl;
+}
+
+
+/**
+ * Parse the command line
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Options to fill
+ * @return True if the command line is valid
+ */
+bool parse_args(int argc, char **argv, Options & options) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                exit(0);
+            } else if ((arg == "-n" || arg == "--iterations") && has_value) {
+                options.iterations = common::to_number<int>(argv[++i]);
+            } else if ((arg == "-w" || arg == "--warmup") && has_value) {
+                options.warmup = common::to_number<int>(argv[++i]);
+            } else if ((arg == "-b" || arg == "--budget") && has_value) {
+                options.budget_s = common::to_number<int>(argv[++i]);
+            } else if ((arg == "-c" || arg == "--cpu") && has_value) {
+                options.cpu = common::to_number<int>(argv[++i]);
+            } else if ((arg == "-d" || arg == "--data") && has_value) {
+                options.data_dir = argv[++i];
+            } else if (arg == "--perf") {
+                options.perf = true;
+            } else if (arg == "--model-cache") {
+                options.model_cache = true;
+            } else if (arg == "--json" && has_value) {
+                options.json_path = argv[++i];
+            } else if (arg == "--csv" && has_value) {
+                options.csv_path = argv[++i];
+            } else if (!runner::parse_days(arg, FACTORIES.size(), options.days)) {
+                return false;
+            }
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+
+    // Default to all days
+    if (options.days.empty()) {
+        for (std::size_t day = 1; day <= FACTORIES.size(); ++day) {
+            options.days.push_back(day);
+        }
+    }
+    return options.iterations > 0;
+}
+
+
+/**
+ * Pin the process to a single CPU, so the scheduler doesn't migrate us mid-sample
+ * @param cpu The CPU to pin to, -1 to use the current CPU
+ * @return The CPU pinned to, or -1 if pinning failed
+ */
+int pin_cpu(int cpu) {
+    if (cpu < 0) {
+        cpu = sched_getcpu();
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (cpu >= 0 && sched_setaffinity(0, sizeof(set), &set) == 0) ? cpu : -1;
+}
+
+
+/**
+ * Linear interpolated quantile of sorted samples
+ * @param sorted The sorted samples
+ * @param q The quantile in [0, 1]
+ * @return The quantile value
+ */
+double quantile(const std::vector<double> & sorted, double q) {
+    if (sorted.empty()) {return 0;}
+    double pos = q * (sorted.size() - 1);
+    std::size_t idx = std::floor(pos);
+    std::size_t next = std::min(idx + 1, sorted.size() - 1);
+    return sorted[idx] + (pos - idx) * (sorted[next] - sorted[idx]);
+}
+
+
+/**
+ * Summarize timing samples, rejecting outliers outside the Tukey fences (1.5 IQR)
+ * @param samples The timing samples
+ * @return Summary statistics over the samples which were kept
+ */
+Summary summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) {return summary;}
+    std::sort(samples.begin(), samples.end());
+
+    // Reject outliers
+    double q1 = quantile(samples, 0.25), q3 = quantile(samples, 0.75);
+    double lower = q1 - 1.5 * (q3 - q1), upper = q3 + 1.5 * (q3 - q1);
+    std::vector<double> kept;
+    for (const auto & sample : samples) {
+        if (sample >= lower && sample <= upper) {kept.push_back(sample);}
+    }
+
+    summary.samples = kept.size();
+    summary.outliers = samples.size() - kept.size();
+    summary.min = kept.front();
+    summary.median = quantile(kept, 0.5);
+    summary.p99 = quantile(kept, 0.99);
+    for (const auto & sample : kept) {summary.mean += sample;}
+    summary.mean /= kept.size();
+    for (const auto & sample : kept) {summary.stddev += (sample - summary.mean) * (sample - summary.mean);}
+    summary.stddev = std::sqrt(summary.stddev / kept.size());
+    return summary;
+}
+
+
+/**
+ * Benchmark a single day. Every iteration gets a fresh solver, so parse is measured
+ * each time and no part sees state left over from a previous iteration.
+ * @param day The day to run
+ * @param options The benchmark options
+ * @param counters Hardware counters to read around each phase, or nullptr
+ * @return The summary for each phase
+ */
+DayBench bench_day(int day, const Options & options, perf::Counters *counters) {
+    DayBench result{.day = day};
+    std::array<std::vector<double>, NUM_PHASES> samples;
+
+    try {
+        const std::string input_path = options.data_dir + "/day" + std::to_string(day) + ".txt";
+        common::Input input = common::Input::from_file(input_path);
+        std::array<perf::Sample, NUM_PHASES> samples_counters;
+        auto run_once = [&]() {
+            std::unique_ptr<runner::Solver> solver = FACTORIES[day - 1]();
+            std::array<double, NUM_PHASES> times;
+            std::array<perf::Sample, NUM_PHASES> sample;
+            runner::Stopwatch stopwatch;
+            for (int phase = 0; phase < NUM_PHASES; ++phase) {
+                stopwatch.reset();
+                if (counters) {counters->start();}
+                if (phase == 0 && options.model_cache) {
+                    solver->parse_cached(input.view(), input_path);
+                } else if (phase == 0) {
+                    solver->parse(input.view());
+                } else if (phase == 1) {
+                    solver->part1();
+                } else {
+                    solver->part2();
+                }
+                if (counters) {sample[phase] = counters->stop();}
+                times[phase] = stopwatch.elapsed_ms();
+            }
+            return std::make_pair(times, sample);
+        };
+
+        // Warmup, slow days cut it short once the budget is used up
+        const double budget_ms = options.budget_s * 1000.0;
+        runner::Stopwatch total;
+        for (int i = 0; i < options.warmup && total.elapsed_ms() < budget_ms; ++i) {
+            run_once();
+        }
+
+        // Measure, slow days stop early once enough samples exist
+        total.reset();
+        for (int i = 0; i < options.iterations; ++i) {
+            auto [times, sample] = run_once();
+            for (int phase = 0; phase < NUM_PHASES; ++phase) {
+                samples[phase].push_back(times[phase]);
+                samples_counters[phase] += sample[phase];
+            }
+            if (i + 1 >= options.min_iterations && total.elapsed_ms() > budget_ms) {
+                break;
+            }
+        }
+        for (int phase = 0; phase < NUM_PHASES; ++phase) {
+            result.counters[phase] = samples_counters[phase];
+            result.counters[phase] /= samples[phase].size();
+        }
+    } catch (const std::exception & e) {
+        result.error = e.what();
+    } catch (const char *e) {
+        result.error = e;
+    }
+
+    for (int phase = 0; phase < NUM_PHASES; ++phase) {
+        result.phases[phase] = summarize(samples[phase]);
+    }
+    return result;
+}
+
+
+void print_header() {
+    std::cout << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::right
+              << std::setw(12) << "min (ms)" << std::setw(12) << "median (ms)" << std::setw(12) << "p99 (ms)"
+              << std::setw(10) << "stddev %" << std::setw(9) << "samples" << std::setw(10) << "outliers" << std::endl;
+}
+
+
+void print_result(const DayBench & result) {
+    if (!result.error.empty()) {
+        std::cout << std::left << std::setw(5) << result.day << "error: " << result.error << std::endl;
+        return;
+    }
+    for (int phase = 0; phase < NUM_PHASES; ++phase) {
+        const Summary & s = result.phases[phase];
+        double rel_stddev = (s.mean > 0) ? 100 * s.stddev / s.mean : 0;
+        std::cout << std::left << std::setw(5) << result.day << std::setw(7) << PHASE_NAMES[phase] << std::right
+                  << std::fixed << std::setprecision(4)
+                  << std::setw(12) << s.min << std::setw(12) << s.median << std::setw(12) << s.p99
+                  << std::setprecision(1) << std::setw(10) << rel_stddev
+                  << std::setw(9) << s.samples << std::setw(10) << s.outliers << std::endl;
+    }
+}
+
+
+void print_counters(const std::vector<DayBench> & results) {
+    std::cout << std::endl << std::left << std::setw(5) << "Day" << std::setw(7) << "Phase" << std::right
+              << std::setw(16) << "Cycles" << std::setw(16) << "Instructions" << std::setw(7) << "IPC"
+              << std::setw(14) << "L1D misses" << std::setw(14) << "LLC misses" << std::setw(14) << "Br misses" << std::endl;
+    for (const auto & r : results) {
+        if (!r.error.empty()) {continue;}
+        for (int phase = 0; phase < NUM_PHASES; ++phase) {
+            const perf::Sample & sample = r.counters[phase];
+            std::cout << std::left << std::setw(5) << r.day << std::setw(7) << PHASE_NAMES[phase] << std::right << std::fixed;
+            for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+                int width = (event == perf::CYCLES || event == perf::INSTRUCTIONS) ? 16 : 14;
+                std::cout << std::setw(width);
+                if (sample.valid[event]) {
+                    std::cout << std::setprecision(0) << sample.values[event];
+                } else {
+                    std::cout << "-";
+                }
+                if (event == perf::INSTRUCTIONS) {
+                    std::cout << std::setw(7) << std::setprecision(2) << sample.ipc();
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+
+void write_json(const std::string & path, const std::vector<DayBench> & results, int cpu) {
+    std::ofstream out(path);
+    out << std::setprecision(6) << "{\n  \"cpu\": " << cpu << ",\n  \"days\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const DayBench & r = results[i];
+        out << (i ? "," : "") << "\n    {\"day\": " << r.day;
+        if (!r.error.empty()) {out << ", \"error\": \"" << r.error << "\"";}
+        for (int phase = 0; phase < NUM_PHASES; ++phase) {
+            const Summary & s = r.phases[phase];
+            out << ", \"" << PHASE_NAMES[phase] << "\": {\"min_ms\": " << s.min << ", \"median_ms\": " << s.median
+                << ", \"p99_ms\": " << s.p99 << ", \"mean_ms\": " << s.mean << ", \"stddev_ms\": " << s.stddev
+                << ", \"samples\": " << s.samples << ", \"outliers\": " << s.outliers;
+            for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+                if (r.counters[phase].valid[event]) {
+                    out << ", \"" << perf::EVENT_NAMES[event] << "\": " << r.counters[phase].values[event];
+                }
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+
+void write_csv(const std::string & path, const std::vector<DayBench> & results) {
+    std::ofstream out(path);
+    out << std::setprecision(6) << "day,phase,min_ms,median_ms,p99_ms,mean_ms,stddev_ms,samples,outliers";
+    for (const auto & name : perf::EVENT_NAMES) {out << "," << name;}
+    out << "\n";
+    for (const auto & r : results) {
+        if (!r.error.empty()) {continue;}
+        for (int phase = 0; phase < NUM_PHASES; ++phase) {
+            const Summary & s = r.phases[phase];
+            out << r.day << "," << PHASE_NAMES[phase] << "," << s.min << "," << s.median << "," << s.p99
+                << "," << s.mean << "," << s.stddev << "," << s.samples << "," << s.outliers;
+            // Counters left empty when unavailable
+            for (int event = 0; event < perf::NUM_EVENTS; ++event) {
+                out << ",";
+                if (r.counters[phase].valid[event]) {out << std::setprecision(0) << std::fixed << r.counters[phase].values[event] << std::defaultfloat << std::setprecision(6);}
+            }
+            out << "\n";
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int cpu = pin_cpu(options.cpu);
+    if (cpu < 0) {
+        std::cerr << "Warning: could not pin to a CPU, expect more noise" << std::endl;
+    }
+
+    std::unique_ptr<perf::Counters> counters;
+    if (options.perf) {
+        counters = std::make_unique<perf::Counters>();
+        if (!counters->available()) {
+            std::cerr << "Warning: hardware counters unavailable (" << counters->error() << "), reporting times only" << std::endl;
+            counters.reset();
+        }
+    }
+
+    print_header();
+    std::vector<DayBench> results;
+    bool has_error = false;
+    for (const auto & day : options.days) {
+        results.push_back(bench_day(day, options, counters.get()));
+        print_result(results.back());
+        has_error |= !results.back().error.empty();
+    }
+
+    if (counters) {print_counters(results);}
+    if (!options.json_path.empty()) {write_json(options.json_path, results, cpu);}
+    if (!options.csv_path.empty()) {write_csv(options.csv_path, results);}
+
+    return has_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
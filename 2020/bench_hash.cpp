@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <random>
+#include <algorithm>            // min
+#include <cstdint>              // types
+
+#include "runner.h"
+#include "flat_hash_map.h"
+
+
+// consts
+const std::vector<std::string> WORKLOADS = {"insert", "reuse", "find_hit", "find_miss", "counter"};
+
+// Command line options
+struct Options {
+    std::vector<std::size_t> sizes = {1 << 10, 1 << 16, 1 << 20};
+    int repeats = 5;
+    uint64_t seed = 1;
+};
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " [options]" << std::endl
+              << "  Times common::FlatHashMap against std::unordered_map on integer keys." << std::endl
+              << "  -n, --size N      Number of keys, can be repeated (default: 1024 65536 1048576)" << std::endl
+              << "  -r, --repeats N   Runs per measurement, the fastest is kept (default: 5)" << std::endl
+              << "  -s, --seed S      Random seed (default: 1)" << std::endl
+              << "  -h, --help        Show this message" << std::endl;
+}
+
+
+/**
+ * Parse the command line
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Options to fill
+ * @return True if the command line is valid
+ */
+bool parse_args(int argc, char **argv, Options & options) {
+    bool custom_sizes = false;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                return false;
+            } else if ((arg == "-n" || arg == "--size") && has_value) {
+                if (!custom_sizes) {options.sizes.clear();}
+                custom_sizes = true;
+                options.sizes.push_back(std::stoull(argv[++i]));
+            } else if ((arg == "-r" || arg == "--repeats") && has_value) {
+                options.repeats = std::stoi(argv[++i]);
+            } else if ((arg == "-s" || arg == "--seed") && has_value) {
+                options.seed = std::stoull(argv[++i]);
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    return options.repeats > 0 && !options.sizes.empty();
+}
+
+
+/**
+ * Time one workload on a map type
+ * @param workload The workload name
+ * @param keys Keys in the map, distinct
+ * @param misses Keys not in the map
+ * @param sink Accumulates results, so the work isn't optimized away
+ * @return Fastest time of the repeats, in ns per operation
+ */
+template <typename Map>
+double run_workload(const std::string & workload, const std::vector<uint64_t> & keys,
+                    const std::vector<uint64_t> & misses, int repeats, uint64_t & sink) {
+    double best = 0;
+    Map reused;
+    Map filled;
+    for (const auto & key : keys) {filled[key] = key;}
+
+    for (int r = 0; r < repeats; ++r) {
+        runner::Stopwatch stopwatch;
+        if (workload == "insert") {
+            // Fresh table, grows as it goes
+            Map map;
+            for (const auto & key : keys) {map[key] = key;}
+            sink += map.size();
+        } else if (workload == "reuse") {
+            // Cleared and refilled, like a table kept across games
+            reused.clear();
+            for (const auto & key : keys) {reused[key] = key;}
+            sink += reused.size();
+        } else if (workload == "find_hit") {
+            for (const auto & key : keys) {sink += filled.find(key)->second;}
+        } else if (workload == "find_miss") {
+            for (const auto & key : misses) {sink += filled.find(key) == filled.end();}
+        } else {
+            // Counting with many repeated keys, half the operations hit
+            Map counts;
+            for (std::size_t i = 0; i < keys.size(); ++i) {++counts[keys[i / 2]];}
+            sink += counts.size();
+        }
+        double ns = stopwatch.elapsed_ms() * 1e6 / (workload == "find_miss" ? misses.size() : keys.size());
+        best = (r == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(options.seed);
+    uint64_t sink = 0;
+    std::cout << std::left << std::setw(12) << "Workload" << std::right << std::setw(10) << "Keys"
+              << std::setw(18) << "unordered (ns)" << std::setw(14) << "flat (ns)" << std::setw(10) << "Speedup" << std::endl;
+
+    for (const auto & size : options.sizes) {
+        // Even keys are in the map, odd ones miss
+        std::vector<uint64_t> keys(size), misses(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            uint64_t key = rng() & 0xFFFFFFFFFULL;
+            keys[i] = key & ~1ULL;
+            misses[i] = key | 1ULL;
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        for (const auto & workload : WORKLOADS) {
+            double unordered = run_workload<std::unordered_map<uint64_t, uint64_t>>(workload, keys, misses, options.repeats, sink);
+            double flat = run_workload<common::FlatHashMap<uint64_t, uint64_t>>(workload, keys, misses, options.repeats, sink);
+            std::cout << std::left << std::setw(12) << workload << std::right << std::setw(10) << keys.size()
+                      << std::fixed << std::setprecision(2) << std::setw(18) << unordered << std::setw(14) << flat
+                      << std::setw(9) << unordered / flat << "x" << std::endl;
+        }
+    }
+
+    // Keeps the results live
+    if (sink == 42) {std::cout << std::endl;}
+    return 0;
+}
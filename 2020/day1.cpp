@@ -3,8 +3,13 @@
 #include <algorithm>        // sort
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day1.h"
 
 
+namespace day1 {
+
 // consts
 const int SUM = 2020;
 const int NO_SOLUTION = -1;
@@ -17,7 +22,7 @@ const int NO_SOLUTION = -1;
  * @param sum_to_fund The sum for the pair to find
  * @return Product of number pair which matches sum
  */
-int solution1_trivial(std::vector<int> &items, int sum_to_find) {
+int solution1_trivial(const std::vector<int> &items, int sum_to_find) {
     // Trivial solution. Here, we simply check every possible pair
     for (std::size_t i = 0; i < items.size(); ++i) {
         for (std::size_t j = i + 1; j < items.size(); ++j) {
@@ -31,21 +36,20 @@ int solution1_trivial(std::vector<int> &items, int sum_to_find) {
 }
 
 /**
- * Same as above, but sorts the list of ints first then 
+ * Same as above, but on the sorted list of ints
  * finds pair by moving left/right points towards center
  * 
- * @param items Vector of numbers
+ * @param items Sorted vector of numbers
  * @param sum_to_fund The sum for the pair to find
  * @return Product of number pair which matches sum
  */
-int solution1(std::vector<int> &items, int sum_to_find) {
-    std::sort(items.begin(), items.end());
-
+int solution1(const std::vector<int> &items, int sum_to_find) {
     auto it_left = items.begin();
     auto it_right = std::prev(items.end());
 
     // Continue until iterators touch or we find solution
     while (it_left != it_right) {
+        AOC_COUNT("day1.pair_steps", 1);
         int left_val = *it_left, right_val = *it_right;
         int curr_sum = left_val + right_val;
 
@@ -74,7 +78,7 @@ int solution1(std::vector<int> &items, int sum_to_find) {
  * @param sum_to_fund The sum for the triplet to find
  * @return Product of number triplet which matches sum
  */
-int solution2_trivial(std::vector<int> &items, int sum_to_find) {
+int solution2_trivial(const std::vector<int> &items, int sum_to_find) {
     for (std::size_t i = 0; i < items.size(); ++i) {
         for (std::size_t j = i + 1; j < items.size(); ++j) {
             for (std::size_t k = j + 1; k < items.size(); ++k) {
@@ -93,13 +97,11 @@ int solution2_trivial(std::vector<int> &items, int sum_to_find) {
  * Same as solution1, but we first lock the first term of the triplet,
  * then use the method from solution 1
  * 
- * @param items Vector of numbers
+ * @param items Sorted vector of numbers
  * @param sum_to_fund The sum for the triplet to find
  * @return Product of number triplet which matches sum
  */
-int solution2(std::vector<int> &items, int sum_to_find) {
-    std::sort(items.begin(), items.end());
-
+int solution2(const std::vector<int> &items, int sum_to_find) {
     // Hold the fist item constant
     for (size_t i = 0; i < items.size(); ++i) {
         int starting_val =  items[i];
@@ -107,6 +109,7 @@ int solution2(std::vector<int> &items, int sum_to_find) {
 
         // Continue until iterators touch or we find solution
         while (it_left != it_right) {
+            AOC_COUNT("day1.triplet_steps", 1);
             int left_val = items[it_left], right_val = items[it_right];
             int curr_sum = left_val + right_val + starting_val;
 
@@ -128,20 +131,23 @@ int solution2(std::vector<int> &items, int sum_to_find) {
     return NO_SOLUTION;
 }
 
-int main() {
-    std::vector<int> items = common::read_stdin<int>();
-    
-    int result1 = solution1(items, SUM);
-    if (result1 == NO_SOLUTION) {
-        std::cout << "No solution found for part 1." << std::endl;
-    } else {
-        std::cout << "Solution for part 1 is " << result1 << std::endl; 
-    }
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed items = common::read_numbers<int>(buffer);
+    std::sort(items.begin(), items.end());
+    return items;
+}
 
-    int result2 = solution2(items, SUM);
-    if (result2 == NO_SOLUTION) {
-        std::cout << "No solution found for part 2." << std::endl;
-    } else {
-        std::cout << "Solution for part 2 is " << result2 << std::endl; 
-    }
-}
\ No newline at end of file
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed, SUM);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed, SUM);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
+
+} // namespace day1
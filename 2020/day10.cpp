@@ -1,24 +1,32 @@
 #include <iostream>
 #include <vector>
+#include <array>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <algorithm>            // sort
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day10.h"
 
 
+namespace day10 {
+
 /**
  * Get the sorted list of jolts for adapters
  * @param lines Vector of strings, each element is a line from stdin
  * @return List of jolts
  */
-std::vector<std::size_t> get_sorted_input(std::vector<std::string> &lines) {
+std::vector<std::size_t> get_sorted_input(const std::vector<std::string_view> &lines) {
     std::vector<std::size_t> nums;
 
     // Get input and sort
     for (const auto & line : lines) {
-        nums.push_back(std::stoll(line));
+        nums.push_back(common::to_number<std::size_t>(line));
     }
+    if (nums.empty()) {throw "Invalid input";}
     std::sort(nums.begin(), nums.end());
     nums.push_back(nums[nums.size() - 1] + 3);
 
@@ -28,16 +36,13 @@ std::vector<std::size_t> get_sorted_input(std::vector<std::string> &lines) {
 
 /**
  * Get the map of jolt differences
- * @param lines Vector of strings, each element is a line from stdin
+ * @param nums Sorted list of jolts
  * @return The map containing jolt difference counts
  */
-std::unordered_map<std::size_t, int> get_difference_map(std::vector<std::string> &lines) {
-    // Get input and sort
-    std::vector<std::size_t> nums = get_sorted_input(lines);
-
+common::FlatHashMap<std::size_t, int> get_difference_map(const std::vector<std::size_t> &nums) {
     // Find differences
     std::size_t prev = 0;
-    std::unordered_map<std::size_t, int> difference_map;
+    common::FlatHashMap<std::size_t, int> difference_map;
     for (const auto & num : nums) {
         ++difference_map[num - prev];
         prev = num;
@@ -48,11 +53,11 @@ std::unordered_map<std::size_t, int> get_difference_map(std::vector<std::string>
 
 /**
  * Finds the difference in jolts (1-jolt * 3-jolt)
- * @param lines Vector of strings, each element is a line from stdin
+ * @param nums Sorted list of jolts
  * @return The product of 1/3 jolt differences
  */
-std::size_t solution1(std::vector<std::string> &lines) {
-    std::unordered_map<std::size_t, int> difference_map = get_difference_map(lines);
+std::size_t solution1(const std::vector<std::size_t> &nums) {
+    common::FlatHashMap<std::size_t, int> difference_map = get_difference_map(nums);
 
     if (difference_map.find(1) == difference_map.end() || difference_map.find(3) == difference_map.end()) {
         throw "Invalid input";
@@ -63,37 +68,49 @@ std::size_t solution1(std::vector<std::string> &lines) {
 
 /**
  * Finds the number of possible adapter configurations
- * @param lines Vector of strings, each element is a line from stdin
+ * @param nums Sorted list of jolts
  * @return The number of valid configurations
  */
-std::size_t solution2(std::vector<std::string> &lines) {
-    // Get input and sort
-    std::vector<std::size_t> nums = get_sorted_input(lines);
-
+std::size_t solution2(const std::vector<std::size_t> &nums) {
     // Track number of paths to reach each option in the jolt list
-    std::unordered_map<std::size_t, std::size_t> path_tracker = {{0, 1}};
+    common::FlatHashMap<std::size_t, std::size_t> path_tracker;
+    path_tracker[0] = 1;
     const std::array<int, 3> deltas = {1, 2, 3};
     for (const auto & num : nums) {
         if (path_tracker.find(num) != path_tracker.end()) {
             continue;
         }
-        // Cache how many ways we could have gotten here
+        // Cache how many ways we could have gotten here, summed before inserting num
+        // since an insert can rehash the table
+        std::size_t paths = 0;
         for (const auto & delta : deltas) {
-            // Might not be in path_tracker, but default construct to 0 doesn't affect sum
-            path_tracker[num] += path_tracker[num-delta];
+            // Jolts not in path_tracker have no paths
+            AOC_COUNT("day10.path_lookups", 1);
+            auto previous = path_tracker.find(num - delta);
+            if (previous != path_tracker.end()) {paths += previous->second;}
         }
+        path_tracker[num] = paths;
     }
 
     return path_tracker[nums[nums.size() - 1]];
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    return get_sorted_input(common::split_lines(buffer));
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    std::size_t num1 = solution1(lines);
-    std::cout << "Jolt difference output in part 1: " << num1 << std::endl;
-    std::size_t num2 = solution2(lines);
-    std::cout << "Number of combinations in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day10
@@ -1,109 +1,109 @@
 #include <iostream>
 #include <vector>
-#include <array>
+#include <cstdint>              // types
+#include <cstddef>              // ptrdiff_t
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "common.h"
+#include "grid.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day11.h"
 
 
+namespace day11 {
+
 // consts
-const int EMPTY = 0;
-const int OCCUPIED = 1;
-const int FLOOR = 2;
-std::unordered_map<char, int> str_seat_map = {
+const uint8_t EMPTY = 0;
+const uint8_t OCCUPIED = 1;
+const uint8_t FLOOR = 2;
+// Border cell, neither a seat nor floor, so sight lines stop on it
+const uint8_t WALL = 3;
+std::unordered_map<char, uint8_t> str_seat_map = {
     {'L', EMPTY},
     {'#', OCCUPIED},
     {'.', FLOOR}
 };
-std::unordered_map<int, char> seat_str_map = {
+std::unordered_map<uint8_t, char> seat_str_map = {
     {EMPTY, 'L'},
     {OCCUPIED, '#'},
     {FLOOR, '.'}
 };
 
-const std::array<std::pair<int, int>, 8> offsets = {{
-    {-1, 0},
-    {-1, 1},
-    {0, 1},
-    {1, 1},
-    {1, 0},
-    {1, -1},
-    {0, -1},
-    {-1, -1}
-}};
-
-struct Grid {
-    int rows, cols;
-    std::vector<std::vector<int>> grid;
-
-    Grid (const std::vector<std::string> &lines) {
-        for (const auto & line : lines) {
-            std::vector<int> row;
-            for (const auto & c : line) {
-                row.push_back(str_seat_map.at(c));
-            }
-            cols = row.size();
-            grid.push_back(row);
+
+void print(const Grid &grid) {
+    for (int row = 0; row < grid.rows(); ++row) {
+        for (int col = 0; col < grid.cols(); ++col) {
+            std::cout << seat_str_map.at(grid(row, col));
         }
-        rows = grid.size();
+        std::cout << std::endl;
     }
+}
 
-    void print() const {
-        for (std::size_t row = 0; row < rows; ++row) {
-            for (std::size_t col = 0; col < cols; ++col) {
-                std::cout << seat_str_map.at(grid[row][col]);
-            }
-            std::cout << std::endl;
+std::size_t get_occupied_count(const Grid &grid) {
+    std::size_t num_occupied = 0;
+    for (int row = 0; row < grid.rows(); ++row) {
+        const uint8_t *seats = grid.row(row);
+        for (int col = 0; col < grid.cols(); ++col) {
+            if (seats[col] == OCCUPIED) {++num_occupied;}
         }
     }
+    return num_occupied;
+}
 
-    bool out_of_bounds(int row, int col) const {
-        return (row < 0 || col < 0 || row >= rows || col >= cols);
-    }
 
-    int get_occupied_count() const {
-        int num_occupied = 0;
-        for (std::size_t row = 0; row < rows; ++row) {
-            for (std::size_t col = 0; col < cols; ++col) {
-                if (grid[row][col] == OCCUPIED) {++num_occupied;}
-            }
-        }
-        return num_occupied;
-    }
+// Working grids of a simulation
+struct Workspace {
+    Grid grid, prev;
+    std::vector<std::ptrdiff_t> neighbours;     // Offsets of the 8 adjacent cells
 };
 
+/**
+ * Per-thread working grids. Copying into them reuses their buffers, so neither
+ * the steps nor later solves (e.g. repeated aocd requests) reallocate the grid
+ */
+Workspace & workspace() {
+    static thread_local Workspace ws;
+    return ws;
+}
+
 
 /**
  * Runs one simulation using simple rules
- * @param grid The grid struct of seats
+ * @param grid The grid of seats, swapped with prev and then overwritten with the next step
+ * @param prev Scratch grid of the same shape, holds the seats before the step afterwards
+ * @param neighbours Offsets of the adjacent cells
  * @return True if there has been a change in the seats
  */
-bool step_simulation1(Grid &grid) {
+bool step_simulation1(Grid &grid, Grid &prev, const std::vector<std::ptrdiff_t> &neighbours) {
+    AOC_TIMER("day11.step_simulation1");
     bool has_changed = false;
-    Grid prev = grid;
-
-    // Simulate
-    for (std::size_t row = 0; row < grid.rows; ++row) {
-        for (std::size_t col = 0; col < grid.cols; ++col) {
+    grid.swap(prev);
+
+    // Simulate, the WALL border counts as unoccupied so edge seats need no bounds checks
+    for (int row = 0; row < prev.rows(); ++row) {
+        const uint8_t *before = prev.row(row);
+        uint8_t *after = grid.row(row);
+        for (int col = 0; col < prev.cols(); ++col) {
+            after[col] = before[col];
             // Rule 3: Skip if floor
-            if (prev.grid[row][col] == FLOOR) {continue;}
+            if (before[col] == FLOOR) {continue;}
             int occupied_counter = 0;
             // Check number of occupied seats
-            for (const auto & offset : offsets) {
-                int row_n = row + offset.first, col_n = col + offset.second;
-                if (prev.out_of_bounds(row_n, col_n)) {continue;}
-                if (prev.grid[row_n][col_n] == OCCUPIED) {++occupied_counter;}
+            for (const auto & offset : neighbours) {
+                occupied_counter += (before[col + offset] == OCCUPIED) ? 1 : 0;
             }
 
             // Rule 1: Seat empty and no occupied seats adjacent
-            if (prev.grid[row][col] == EMPTY && occupied_counter == 0) {
-                grid.grid[row][col] = OCCUPIED;
+            if (before[col] == EMPTY && occupied_counter == 0) {
+                after[col] = OCCUPIED;
                 has_changed = true;
             }
             // Rule 2: Seat occupied and 4+ seats adjacent are occupied
-            if (prev.grid[row][col] == OCCUPIED && occupied_counter >= 4) {
-                grid.grid[row][col] = EMPTY;
+            if (before[col] == OCCUPIED && occupied_counter >= 4) {
+                after[col] = EMPTY;
                 has_changed = true;
             }
         }
@@ -115,41 +115,44 @@ bool step_simulation1(Grid &grid) {
 
 /**
  * Runs one simulation using complex rules
- * @param grid The grid struct of seats
+ * @param grid The grid of seats, swapped with prev and then overwritten with the next step
+ * @param prev Scratch grid of the same shape, holds the seats before the step afterwards
+ * @param neighbours Offsets of the adjacent cells, the directions of the sight lines
  * @return True if there has been a change in the seats
  */
-bool step_simulation2(Grid &grid) {
+bool step_simulation2(Grid &grid, Grid &prev, const std::vector<std::ptrdiff_t> &neighbours) {
+    AOC_TIMER("day11.step_simulation2");
     bool has_changed = false;
-    Grid prev = grid;
+    grid.swap(prev);
 
     // Simulate
-    for (std::size_t row = 0; row < grid.rows; ++row) {
-        for (std::size_t col = 0; col < grid.cols; ++col) {
+    for (int row = 0; row < prev.rows(); ++row) {
+        const uint8_t *before = prev.row(row);
+        uint8_t *after = grid.row(row);
+        for (int col = 0; col < prev.cols(); ++col) {
+            after[col] = before[col];
             // Rule 3: Skip if floor
-            if (prev.grid[row][col] == FLOOR) {continue;}
+            if (before[col] == FLOOR) {continue;}
             int occupied_counter = 0;
             // Check number of occupied seats
-            for (const auto & offset : offsets) {
-                int row_n = row + offset.first, col_n = col + offset.second;
-                // Scan down the direction
-                while (!prev.out_of_bounds(row_n, col_n)) {
-                    if (prev.grid[row_n][col_n] != FLOOR) {
-                        occupied_counter += (prev.grid[row_n][col_n] == OCCUPIED) ? 1 : 0;
-                        break;
-                    }
-                    row_n += offset.first;
-                    col_n += offset.second;
+            for (const auto & offset : neighbours) {
+                // Scan down the direction, every sight line ends at a seat or the WALL border
+                const uint8_t *seen = before + col + offset;
+                while (*seen == FLOOR) {
+                    AOC_COUNT("day11.sight_line_steps", 1);
+                    seen += offset;
                 }
+                occupied_counter += (*seen == OCCUPIED) ? 1 : 0;
             }
 
             // Rule 1: Seat empty and no occupied seats adjacent
-            if (prev.grid[row][col] == EMPTY && occupied_counter == 0) {
-                grid.grid[row][col] = OCCUPIED;
+            if (before[col] == EMPTY && occupied_counter == 0) {
+                after[col] = OCCUPIED;
                 has_changed = true;
             }
             // Rule 2: Seat occupied and 5+ seats adjacent are occupied
-            if (prev.grid[row][col] == OCCUPIED && occupied_counter >= 5) {
-                grid.grid[row][col] = EMPTY;
+            if (before[col] == OCCUPIED && occupied_counter >= 5) {
+                after[col] = EMPTY;
                 has_changed = true;
             }
         }
@@ -161,34 +164,54 @@ bool step_simulation2(Grid &grid) {
 
 /**
  * Finds the number of simulations until a steady state is reached
- * @param lines Vector of strings, each element is a line from stdin
+ * @param seats The initial grid of seats
  * @return The number of simulations
  */
-std::size_t solution1(const std::vector<std::string> &lines) {
-    Grid grid(lines);
-    while (step_simulation1(grid)) {}
-    return grid.get_occupied_count();
+std::size_t solution1(const Grid &seats) {
+    Workspace & ws = workspace();
+    ws.grid = seats;
+    ws.prev = seats;
+    ws.neighbours = seats.neighbour_offsets();
+    while (step_simulation1(ws.grid, ws.prev, ws.neighbours)) {
+        AOC_COUNT("day11.iterations1", 1);
+    }
+    return get_occupied_count(ws.grid);
 }
 
 
 /**
  * Finds the number of simulations until a steady state is reached
- * @param lines Vector of strings, each element is a line from stdin
+ * @param seats The initial grid of seats
  * @return The number of simulations
  */
-std::size_t solution2(const std::vector<std::string> &lines) {
-    Grid grid(lines);
-    while (step_simulation2(grid)) {}
-    return grid.get_occupied_count();
+std::size_t solution2(const Grid &seats) {
+    Workspace & ws = workspace();
+    ws.grid = seats;
+    ws.prev = seats;
+    ws.neighbours = seats.neighbour_offsets();
+    while (step_simulation2(ws.grid, ws.prev, ws.neighbours)) {
+        AOC_COUNT("day11.iterations2", 1);
+    }
+    return get_occupied_count(ws.grid);
+}
+
+
+// Library API
+Parsed parse(std::string_view buffer) {
+    return common::grid_from_lines<uint8_t>(common::split_lines(buffer),
+                                            [](char c) {return str_seat_map.at(c);}, 1, WALL);
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
 }
 
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    std::size_t num1 = solution1(lines);
-    std::cout << "Number of seats occupied at equilibrium in part 1: " << num1 << std::endl;
-    std::size_t num2 = solution2(lines);
-    std::cout << "Number of seats occupied at equilibrium in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day11
@@ -7,10 +7,14 @@
 #include <cstdlib>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day12.h"
 
 
+namespace day12 {
+
 // consts
-enum DIR {NORTH, EAST, SOUTH, WEST, DIR_MAX, LEFT, RIGHT, FORWARD};
 const std::unordered_map<char, DIR> str_dir_map = {
     {'N', DIR::NORTH},
     {'E', DIR::EAST},
@@ -36,108 +40,151 @@ int positive_modulo(int i, int n) {
 }
 
 
-struct Ship {
-    std::pair<int, int> coords;
-    std::pair<int, int> waypoint;
-    DIR cur_dir;
+// Rotate ship by given direction + angle
+void Ship::rotate(DIR dir, int angle) {
+    assert (dir == DIR::LEFT || dir == DIR::RIGHT);
+    int multiplier = (dir == DIR::RIGHT) ? 1 : -1;
+    while (angle > 0) {
+        AOC_COUNT("day12.quarter_turns", 1);
+        waypoint = {multiplier * waypoint.second, -multiplier * waypoint.first};
+        angle -= 90;
+    }
+}
 
-    // Ship starts at origin facing east
-    Ship (std::pair<int, int> start = {0, 1}) : coords({0, 0}), waypoint(start), cur_dir(DIR::EAST) {}
+// Move the waypoint along the given direction
+void Ship::move_waypoint(DIR dir, int distance) {
+    assert (dir < DIR::DIR_MAX);
+    std::pair<int, int> displacement = dir_offset_map.at(dir);
+    waypoint.first += displacement.first * distance;
+    waypoint.second += displacement.second * distance;
+}
 
-    // Rotate ship by given direction + angle
-    void rotate(DIR dir, int angle) {
-        assert (dir == DIR::LEFT || dir == DIR::RIGHT);
-        int multiplier = (dir == DIR::RIGHT) ? 1 : -1;
-        while (angle > 0) {
-            waypoint = {multiplier * waypoint.second, -multiplier * waypoint.first};
-            angle -= 90;
-        }
-    }
+// Move in waypoint direction
+void Ship::move(int distance) {
+    coords.first += distance * waypoint.first;
+    coords.second += distance * waypoint.second;
+}
+
+// Move in direction (disregarding the waypoint)
+void Ship::move(DIR dir, int distance) {
+    std::pair<int, int> displacement = dir_offset_map.at(dir);
+    coords.first += distance * displacement.first;
+    coords.second += distance * displacement.second;
+}
 
-    // Move the waypoint along the given direction
-    void move_waypoint(DIR dir, int distance) {
-        assert (dir < DIR::DIR_MAX);
-        std::pair<int, int> displacement = dir_offset_map.at(dir);
-        waypoint.first += displacement.first * distance;
-        waypoint.second += displacement.second * distance;
-    }
 
-    // Move in waypoint direction
-    void move(int distance) {
-        coords.first += distance * waypoint.first;
-        coords.second += distance * waypoint.second;
+/**
+ * Apply an action with part 1's rules, directions move the ship
+ * @param ship The ship
+ * @param action The navigation action
+ */
+void navigate1(Ship &ship, const Action &action) {
+    const auto & [dir, distance] = action;
+    if (dir == DIR::LEFT || dir == DIR::RIGHT) {
+        ship.rotate(dir, distance);
+    } else if (dir < DIR::DIR_MAX) {
+        ship.move(dir, distance);
+    } else {
+        ship.move(distance);
     }
+}
+
 
-    // Move in direction (disregarding the waypoint)
-    void move(DIR dir, int distance) {
-        std::pair<int, int> displacement = dir_offset_map.at(dir);
-        coords.first += distance * displacement.first;
-        coords.second += distance * displacement.second;
+/**
+ * Apply an action with part 2's rules, directions move the waypoint
+ * @param ship The ship
+ * @param action The navigation action
+ */
+void navigate2(Ship &ship, const Action &action) {
+    const auto & [dir, distance] = action;
+    if (dir == DIR::LEFT || dir == DIR::RIGHT) {
+        ship.rotate(dir, distance);
+    } else if (dir < DIR::DIR_MAX) {
+        ship.move_waypoint(dir, distance);
+    } else {
+        ship.move(distance);
     }
-};
+}
 
 
+// Manhattan distance from the origin
+std::size_t distance(const Ship &ship) {
+    return std::abs(ship.coords.first) + std::abs(ship.coords.second);
+}
+
+
+Action get_action(std::string_view line) {
+    return {str_dir_map.at(line[0]), common::to_number<int>(line.substr(1))};
+}
+
 
 /**
  * Moves the ship and find manhattan distance travelled
- * @param lines Vector of strings, each element is a line from stdin
+ * @param actions The navigation actions
  * @return The manhattan distance
  */
-std::size_t solution1(const std::vector<std::string> &lines) {
+std::size_t solution1(const std::vector<Action> &actions) {
     Ship ship;
 
     // Move ship
-    for (const auto & line : lines) {
-        DIR dir = str_dir_map.at(line[0]);
-        int distance = std::stoi(line.substr(1));
-
-        if (dir == DIR::LEFT || dir == DIR::RIGHT) {
-            ship.rotate(dir, distance);
-        } else if (dir < DIR::DIR_MAX) {
-            ship.move(dir, distance);
-        } else {
-            ship.move(distance);
-        }
+    for (const auto & action : actions) {
+        navigate1(ship, action);
     }
-    
-    // Manhattan distance
-    return std::abs(ship.coords.first) + std::abs(ship.coords.second);
+
+    return distance(ship);
 }
 
 
 /**
  * Moves the ship and find manhattan distance travelled
- * @param lines Vector of strings, each element is a line from stdin
+ * @param actions The navigation actions
  * @return The manhattan distance
  */
-std::size_t solution2(const std::vector<std::string> &lines) {
+std::size_t solution2(const std::vector<Action> &actions) {
     Ship ship({-1, 10});
 
     // Move ship
-    for (const auto & line : lines) {
-        DIR dir = str_dir_map.at(line[0]);
-        int distance = std::stoi(line.substr(1));
-
-        if (dir == DIR::LEFT || dir == DIR::RIGHT) {
-            ship.rotate(dir, distance);
-        } else if (dir < DIR::DIR_MAX) {
-            ship.move_waypoint(dir, distance);
-        } else {
-            ship.move(distance);
-        }
+    for (const auto & action : actions) {
+        navigate2(ship, action);
     }
-    
-    // Manhattan distance
-    return std::abs(ship.coords.first) + std::abs(ship.coords.second);
+
+    return distance(ship);
+}
+
+
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed actions;
+    for (const auto & line : common::split_lines(buffer)) {
+        actions.push_back(get_action(line));
+    }
+    return actions;
 }
 
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+void Stream::consume(std::string_view line) {
+    Action action = get_action(line);
+    navigate1(ship1, action);
+    navigate2(ship2, action);
+}
+
+Answer1 Stream::part1() const {
+    return distance(ship1);
+}
+
+Answer2 Stream::part2() const {
+    return distance(ship2);
+}
 
-    std::size_t num1 = solution1(lines);
-    std::cout << "Manhattan distance in part 1: " << num1 << std::endl;
-    std::size_t num2 = solution2(lines);
-    std::cout << "Manhattan distance in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day12
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <utility>              // pair
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 12 solver library, see day12.cpp for the solutions
+ */
+namespace day12 {
+
+enum DIR {NORTH, EAST, SOUTH, WEST, DIR_MAX, LEFT, RIGHT, FORWARD};
+
+// One navigation action, e.g. "F10" is {FORWARD, 10}
+struct Action {
+    DIR dir;
+    int value;
+};
+
+// Ship position, the waypoint doubles as the heading in part 1
+struct Ship {
+    std::pair<int, int> coords;
+    std::pair<int, int> waypoint;
+    DIR cur_dir;
+
+    // Ship starts at origin facing east
+    Ship (std::pair<int, int> start = {0, 1}) : coords({0, 0}), waypoint(start), cur_dir(DIR::EAST) {}
+
+    // Rotate ship by given direction + angle
+    void rotate(DIR dir, int angle);
+
+    // Move the waypoint along the given direction
+    void move_waypoint(DIR dir, int distance);
+
+    // Move in waypoint direction
+    void move(int distance);
+
+    // Move in direction (disregarding the waypoint)
+    void move(DIR dir, int distance);
+};
+
+typedef std::vector<Action> Parsed;
+typedef std::size_t Answer1;
+typedef std::size_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Manhattan distance in part 1: ";
+const char PART2_LABEL[] = "Manhattan distance in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const;
+    Answer2 part2() const;
+
+private:
+    Ship ship1, ship2{{-1, 10}};
+};
+
+} // namespace day12
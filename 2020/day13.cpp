@@ -1,38 +1,58 @@
 #include <iostream>
-#include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <algorithm>            // min
+#include <limits>             // numeric_limits
 #include <cassert>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day13.h"
 
 
+namespace day13 {
+
 /**
- * Gets the bus ID multiplied by the time waiting
+ * Parse the earliest timestamp and the known bus ids with their offset in the schedule
  * @param lines Vector of strings, each element is a line from stdin
- * @return Bus ID multiplied by the time waiting
+ * @return The bus notes
  */
-std::size_t solution1(const std::vector<std::string> &lines) {
-    assert (lines.size() == 2);
-    int timestamp = std::stoll(lines[0]);
-    std::vector<int> ids;
-    std::stringstream s_stream(lines[1]);
+Notes get_notes(const std::vector<std::string_view> &lines) {
+    if (lines.size() != 2) {throw "Invalid input";}
+    Notes notes;
+    notes.timestamp = common::to_number<int>(lines[0]);
+    std::string_view schedule = lines[1];
 
     // Get known interval ids
-    while(s_stream.good()) {
-        std::string substr;
-        std::getline(s_stream, substr, ',');
+    int offset = 0;
+    while (!schedule.empty()) {
+        std::string_view substr = schedule.substr(0, schedule.find(','));
         if (substr != "x") {
-            ids.push_back(std::stoi(substr));
+            notes.ids.push_back(common::to_number<int>(substr));
+            notes.offsets.push_back(offset);
         }
+        schedule.remove_prefix(std::min(substr.size() + 1, schedule.size()));
+        ++offset;
     }
-    
+    if (notes.ids.empty()) {throw "No bus ids";}
+
+    return notes;
+}
+
+
+/**
+ * Gets the bus ID multiplied by the time waiting
+ * @param notes The bus notes
+ * @return Bus ID multiplied by the time waiting
+ */
+std::size_t solution1(const Notes &notes) {
     // Find min waiting time
     int min_time = std::numeric_limits<int>::max();
     int min_id = -1;
-    for (const auto & id : ids) {
-        std::cout << id;
-        int time_to_wait = id - (timestamp % id);
+    for (const auto & id : notes.ids) {
+        int time_to_wait = id - (notes.timestamp % id);
         if (time_to_wait < min_time) {
             min_id = id;
             min_time = time_to_wait;
@@ -46,32 +66,19 @@ std::size_t solution1(const std::vector<std::string> &lines) {
 
 /**
  * Gets the bus ID multiplied by the time waiting
- * @param lines Vector of strings, each element is a line from stdin
+ * @param notes The bus notes
  * @return Bus ID multiplied by the time waiting
  */
-std::size_t solution2(const std::vector<std::string> &lines) {
-    assert (lines.size() == 2);
-    std::vector<int> ids;
-    std::vector<int> offsets;
-    std::stringstream s_stream(lines[1]);
-
-    // Get known interval ids
-    int offset = 0;
-    while(s_stream.good()) {
-        std::string substr;
-        std::getline(s_stream, substr, ',');
-        if (substr != "x") {
-            ids.push_back(std::stoi(substr));
-            offsets.push_back(offset);
-        }
-        ++offset;
-    }
+std::size_t solution2(const Notes &notes) {
+    const std::vector<int> &ids = notes.ids;
+    const std::vector<int> &offsets = notes.offsets;
 
     // Jump in increments that work
     std::size_t increment = ids[0];
     std::size_t candidate_time = ids[0];
     for (std::size_t i = 1; i < ids.size(); ++i) {
         while ((candidate_time + offsets[i]) % ids[i] != 0) {
+            AOC_COUNT("day13.candidate_times", 1);
             candidate_time += increment;
         }
         increment *= ids[i];
@@ -81,12 +88,21 @@ std::size_t solution2(const std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    return get_notes(common::split_lines(buffer));
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    std::size_t num1 = solution1(lines);
-    std::cout << "Bus in part 1: " << num1 << std::endl;
-    std::size_t num2 = solution2(lines);
-    std::cout << "Bus in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day13
@@ -1,14 +1,19 @@
 #include <iostream>
 #include <vector>
-#include <unordered_map>
 #include <string>
 #include <algorithm>            // replace, count
 #include <cstdint>              // types
 #include <cassert>
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day14.h"
 
 
+namespace day14 {
+
 // consts
 const std::string default_mask = "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX";
 
@@ -45,27 +50,45 @@ uint64_t mask_value(uint64_t value, const std::string mask) {
 }
 
 
+/**
+ * Decode a program line
+ * @param line The line, e.g. "mem[8] = 11" or "mask = XXX...X0X"
+ * @return The instruction
+ */
+Instruction get_instruction(const std::string &line) {
+    std::size_t val_idx = line.find(" = ") + 3;
+    std::size_t mem_start = line.find("["), mem_end = line.find("]");
+    Instruction instruction{false, "", 0, 0};
+
+    if (mem_start != std::string::npos) {
+        // Memory write
+        instruction.addr = std::stoull(line.substr(mem_start + 1, mem_end - mem_start - 1));
+        instruction.value = std::stoull(line.substr(val_idx));
+    } else {
+        // Mask update
+        instruction.is_mask = true;
+        instruction.mask = line.substr(val_idx);
+    }
+    return instruction;
+}
+
+
 /**
  * Gets the program memory sum
- * @param lines Vector of strings, each element is a line from stdin
+ * @param program The decoded program
  * @return Sum of values remaining in memory
  */
-uint64_t solution1(const std::vector<std::string> &lines) {
+uint64_t solution1(const std::vector<Instruction> &program) {
     std::string mask = default_mask;
-    std::unordered_map<uint64_t, uint64_t> memory;
+    common::FlatHashMap<uint64_t, uint64_t> memory;
 
-    for (const auto & line : lines) {
-        std::size_t val_idx = line.find(" = ") + 3;
-        std::size_t mem_start = line.find("["), mem_end = line.find("]");
-        
-        if (mem_start != std::string::npos) {
+    for (const auto & instruction : program) {
+        if (!instruction.is_mask) {
             // Set memory value
-            uint64_t addr = std::stoll(line.substr(mem_start + 1, mem_start - mem_end));
-            uint64_t value = std::stoll(line.substr(val_idx));
-            memory[addr] = mask_value(value, mask);
+            memory[instruction.addr] = mask_value(instruction.value, mask);
         }  else {
             // Set mask
-            mask = line.substr(val_idx);
+            mask = instruction.mask;
         }
     }
 
@@ -80,27 +103,25 @@ uint64_t solution1(const std::vector<std::string> &lines) {
 
 /**
  * Gets the program memory sum
- * @param lines Vector of strings, each element is a line from stdin
+ * @param program The decoded program
  * @return Sum of values remaining in memory
  */
-uint64_t solution2(const std::vector<std::string> &lines) {
+uint64_t solution2(const std::vector<Instruction> &program) {
     std::string mask = default_mask;
-    std::unordered_map<uint64_t, uint64_t> memory;
+    common::FlatHashMap<uint64_t, uint64_t> memory;
 
-    for (const auto & line : lines) {
-        std::size_t val_idx = line.find(" = ") + 3;
-        std::size_t mem_start = line.find("["), mem_end = line.find("]");
-        
-        if (mem_start != std::string::npos) {
+    for (const auto & instruction : program) {
+        if (!instruction.is_mask) {
             // Set initial address
-            uint64_t addr = std::stoull(line.substr(mem_start + 1, mem_start - mem_end));
-            uint64_t value = std::stoull(line.substr(val_idx));
+            uint64_t addr = instruction.addr;
+            uint64_t value = instruction.value;
             std::string addr_mask = mask;
             std::replace(addr_mask.begin(), addr_mask.end(), '0', 'X');
             addr = mask_value(addr, addr_mask);
 
             // Loop for each 2^n possibilities of the float bits
             std::size_t num_x = std::count(mask.begin(), mask.end(), 'X');
+            AOC_HISTOGRAM("day14.floating_bits", num_x);
             for (std::size_t bit_seq = 0; bit_seq < (1 << num_x); ++bit_seq) {
                 uint64_t curr_addr = addr;
                 uint64_t bit_idx = 0;
@@ -113,11 +134,12 @@ uint64_t solution2(const std::vector<std::string> &lines) {
                         ++bit_idx;
                     }
                 }
+                AOC_COUNT("day14.memory_writes", 1);
                 memory[curr_addr] = value;
             }
         } else {
             // Set mask
-            mask = line.substr(val_idx);
+            mask = instruction.mask;
         }
     }
 
@@ -130,12 +152,25 @@ uint64_t solution2(const std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed program;
+    for (const auto & line : common::split_lines(buffer)) {
+        program.push_back(get_instruction(std::string(line)));
+    }
+    return program;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    uint64_t num1 = solution1(lines);
-    std::cout << "Sum of memory in part 1: " << num1 << std::endl;
-    uint64_t num2 = solution2(lines);
-    std::cout << "Sum of memory in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day14
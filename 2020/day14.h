@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 14 solver library, see day14.cpp for the solutions
+ */
+namespace day14 {
+
+// Either a mask update or a memory write
+struct Instruction {
+    bool is_mask;
+    std::string mask;
+    uint64_t addr;
+    uint64_t value;
+};
+
+typedef std::vector<Instruction> Parsed;
+typedef uint64_t Answer1;
+typedef uint64_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Sum of memory in part 1: ";
+const char PART2_LABEL[] = "Sum of memory in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day14
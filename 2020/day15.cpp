@@ -1,12 +1,17 @@
 #include <iostream>
 #include <vector>
-#include <unordered_map>
 #include <string>
 #include <cassert>
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day15.h"
 
 
+namespace day15 {
+
 // consts
 const int DURATION1 = 2020;
 const int DURATION2 = 30000000;
@@ -15,10 +20,12 @@ const int DURATION2 = 30000000;
  * Plays the memory game up to the duraction
  * @param lines Vector of ints from stdin
  * @param duration The duration of the game
+ * @param counter_map Table of the round each number was last spoken in, cleared first
  * @return The last number spoken
  */
-int play_game(const std::vector<int> & numbers, int duration) {
-    std::unordered_map<int, int> counter_map;
+int play_game(const std::vector<int> & numbers, int duration, common::FlatHashMap<int, int> & counter_map) {
+    AOC_TIMER("day15.play_game");
+    counter_map.clear();
     int counter = 0;
     int last_number = -1;
     int last_idx = -1;
@@ -26,11 +33,14 @@ int play_game(const std::vector<int> & numbers, int duration) {
 
     // Run one round of speaking game
     auto run_round = [&](int number) {
-        new_number = (counter_map.find(number) == counter_map.end());
+        auto [it, inserted] = counter_map.try_emplace(number, 0);
+        new_number = inserted;
+        AOC_COUNT("day15.rounds", 1);
+        AOC_COUNT("day15.new_numbers", new_number);
         if (!new_number) {
-            last_idx = counter_map[number];
+            last_idx = it->second;
         }
-        counter_map[number] = ++counter;
+        it->second = ++counter;
         last_number = number;
     };
 
@@ -44,6 +54,7 @@ int play_game(const std::vector<int> & numbers, int duration) {
         int number = (new_number ? 0 : counter_map[last_number] - last_idx);
         run_round(number);
     }
+    AOC_HISTOGRAM("day15.distinct_numbers", counter_map.size());
     return last_number;
 }
 
@@ -53,7 +64,8 @@ int play_game(const std::vector<int> & numbers, int duration) {
  * @return 2020th number spoken
  */
 int solution1(const std::vector<int> & numbers) {
-    return play_game(numbers, DURATION1);
+    common::FlatHashMap<int, int> counter_map;
+    return play_game(numbers, DURATION1, counter_map);
 }
 
 
@@ -63,16 +75,28 @@ int solution1(const std::vector<int> & numbers) {
  * @return 30000000th number spoken
  */
 int solution2(const std::vector<int> & numbers) {
-    return play_game(numbers, DURATION2);
+    // Millions of distinct numbers, so each thread keeps its table (clear() keeps the slots)
+    // for the next game instead of growing a new one, which helps long-lived callers (aocd)
+    static thread_local common::FlatHashMap<int, int> counter_map;
+    return play_game(numbers, DURATION2, counter_map);
+}
+
+
+// Library API
+Parsed parse(std::string_view buffer) {
+    return common::read_numbers<int>(buffer, ',');
 }
 
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<int> numbers = common::read_stdin<int>(',');
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    uint64_t num1 = solution1(numbers);
-    std::cout << "Number spoken in part 1: " << num1 << std::endl;
-    uint64_t num2 = solution2(numbers);
-    std::cout << "Number spoken in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day15
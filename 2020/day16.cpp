@@ -4,47 +4,41 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <string>
-#include <sstream>
-#include <regex>           
+#include <string_view>
+#include <algorithm>            // min
 #include <cstdint>              // types
 #include <cassert>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day16.h"
 
 
-// consts
-typedef std::array<int, 2> RuleRange;
-struct Rule {
-    std::string rule_name;
-    RuleRange range1, range2;
-
-    Rule (const std::string & name, RuleRange r1, RuleRange r2) 
-        : rule_name(name), range1(r1), range2(r2) 
-    {}
+namespace day16 {
 
-    bool in_range(int num) const {
-        return (num >= range1[0] && num <= range1[1]) || (num >= range2[0] && num <= range2[1]);
-    }
-};
+// consts
+const char DIGITS[] = "0123456789";
 
 
 /**
  * Get the rule struct from the string input
  * @param line The string line
+ * @param rule_names The rule names, the rule's name is added
  * @return The rule struct
  */
-Rule get_rule(const std::string & line) {
-    std::string rule_name = line.substr(0, line.find(":"));
+Rule get_rule(const std::string & line, common::Interner & rule_names) {
+    common::Interner::Id rule_name = rule_names.intern(std::string_view(line).substr(0, line.find(":")));
     std::vector<int> nums;
-
-    std::smatch match;
-    std::string s = line;
-    std::regex rgx("[0-9]+");
+    std::string_view s = line;
+    std::size_t start;
     
     // Get all ranges
-    while (std::regex_search (s, match, rgx)) {
-        nums.push_back(std::stoll(match[0].str()));
-        s = match.suffix().str();
+    while ((start = s.find_first_of(DIGITS)) != std::string_view::npos) {
+        s.remove_prefix(start);
+        std::size_t len = std::min(s.find_first_not_of(DIGITS), s.size());
+        nums.push_back(common::to_number<int>(s.substr(0, len)));
+        s.remove_prefix(len);
     }
     assert (nums.size() == 4);
     return {rule_name, {nums[0], nums[1]}, {nums[2], nums[3]}};
@@ -57,15 +51,7 @@ Rule get_rule(const std::string & line) {
  * @return A vector of ints representing the ticket
  */
 std::vector<int> get_ticket_nums(const std::string & line) {
-    std::vector<int> nums;
-    std::stringstream ss(line);
-
-    for (int i; ss >> i;) {
-        nums.push_back(i);    
-        if (ss.peek() == ',') {ss.ignore();}
-    }
-
-    return nums;
+    return common::read_numbers<int>(line, ',');
 }
 
 /**
@@ -74,8 +60,9 @@ std::vector<int> get_ticket_nums(const std::string & line) {
  * @param num The ticket number to check
  * @return True if the ticket is valid
  */
-bool is_num_valid(std::vector<Rule> rules, int num) {
+bool is_num_valid(const std::vector<Rule> &rules, int num) {
     for (const auto & rule : rules) {
+        AOC_COUNT("day16.range_checks", 1);
         if (rule.in_range(num)) {
             return true;
         }
@@ -85,28 +72,43 @@ bool is_num_valid(std::vector<Rule> rules, int num) {
 
 
 /**
- * Gets the sum of invalid ticker numbers
+ * Parse the rules, our ticket and the nearby tickets
  * @param lines Vector of strings, each element is a line from stdin
- * @return Sum of values remaining in memory
+ * @return The ticket notes
  */
-uint64_t solution1(const std::vector<std::string> &lines) {
-    std::vector<Rule> rules;
+Notes get_notes(const std::vector<std::string> &lines) {
+    Notes notes;
     std::size_t i = 0;
 
     // Get rules
-    while (lines[i] != "") {
+    while (i < lines.size() && lines[i] != "") {
         const std::string & line = lines[i++];
-        rules.push_back(get_rule(line));
+        notes.rules.push_back(get_rule(line, notes.rule_names));
     }
+    if (i + 2 >= lines.size()) {throw "Missing ticket sections";}
+
+    // Our ticket follows its header, the nearby tickets section starts 5 lines after the rules
+    notes.my_ticket = get_ticket_nums(lines[i+2]);
+    for (i += 5; i < lines.size(); ++i) {
+        notes.nearby_tickets.push_back(get_ticket_nums(lines[i]));
+    }
+
+    return notes;
+}
+
+
+/**
+ * Gets the sum of invalid ticker numbers
+ * @param notes The ticket notes
+ * @return Sum of values remaining in memory
+ */
+uint64_t solution1(const Notes &notes) {
+    const std::vector<Rule> &rules = notes.rules;
 
-    // Bring forward to nearby tickets section
-    i += 5;
-    
     // Check nearby tickets
     uint64_t invalid_sum = 0;
-    while (i < lines.size()) {
-        const std::string & line = lines[i++];
-        for (const auto & num : get_ticket_nums(line)) {
+    for (const auto & ticket : notes.nearby_tickets) {
+        for (const auto & num : ticket) {
             // Check if number falls into known range
             if (!is_num_valid(rules, num)) {
                 invalid_sum += num;
@@ -121,27 +123,18 @@ uint64_t solution1(const std::vector<std::string> &lines) {
 
 /**
  * Gets the sum of invalid ticker numbers
- * @param lines Vector of strings, each element is a line from stdin
+ * @param notes The ticket notes
  * @return Sum of values remaining in memory
  */
-uint64_t solution2(const std::vector<std::string> &lines) {
-    std::vector<Rule> rules;
-    std::size_t i = 0;
-
-    // Get rules
-    while (lines[i] != "") {
-        const std::string & line = lines[i++];
-        rules.push_back(get_rule(line));
-    }
+uint64_t solution2(const Notes &notes) {
+    const std::vector<Rule> &rules = notes.rules;
 
-    // Bring forward to nearby tickets section and add our own ticket
-    std::vector<std::vector<int>> valid_ticket_nums = {get_ticket_nums(lines[i+2])};
-    i += 5;
+    // Start with our own ticket
+    std::vector<std::vector<int>> valid_ticket_nums = {notes.my_ticket};
     
     // Keep valid nearby tickets
-    while (i < lines.size()) {
+    for (const auto & nums : notes.nearby_tickets) {
         bool valid = true;
-        std::vector<int> nums = get_ticket_nums(lines[i++]);
         for (const auto & num : nums) {
             // Check if number falls into known range
             if (!is_num_valid(rules, num)) {
@@ -154,16 +147,13 @@ uint64_t solution2(const std::vector<std::string> &lines) {
     }
 
     // Initialize all rules as being possible for each index
-    std::vector<std::unordered_set<int>> possibilities;
-    for (const auto r : rules) {
-        std::unordered_set<int> options;
-        for (int k = 0; k < rules.size(); ++k) { options.insert(k); }
-        possibilities.push_back(options);
-    }
+    std::unordered_set<int> options;
+    for (std::size_t k = 0; k < rules.size(); ++k) { options.insert(k); }
+    std::vector<std::unordered_set<int>> possibilities(rules.size(), options);
 
     // Start to find rules which do not work
     for (const auto & nums : valid_ticket_nums) {
-        for (int j = 0; j < nums.size(); ++j) {
+        for (std::size_t j = 0; j < nums.size(); ++j) {
             for (std::size_t k = 0; k < rules.size(); ++k) {
                 // Rule not satisfied
                 if (!rules[k].in_range(nums[j])) { possibilities[k].erase(j); }
@@ -173,10 +163,11 @@ uint64_t solution2(const std::vector<std::string> &lines) {
 
     // Start to find solution
     std::unordered_map<int, int> mapping;
-    for (int j = 0; j < rules.size(); ++j) {
-        for (int k = 0; k < possibilities.size(); ++k) {
+    for (std::size_t j = 0; j < rules.size(); ++j) {
+        for (std::size_t k = 0; k < possibilities.size(); ++k) {
             // Look for possibilities with only 1 option
             if (possibilities[k].size() == 1) {
+                AOC_COUNT("day16.eliminations", 1);
                 int idx = *possibilities[k].begin();
                 mapping[k] = idx;
 
@@ -188,10 +179,10 @@ uint64_t solution2(const std::vector<std::string> &lines) {
     }
 
     uint64_t invalid_prod = 1;
-    std::vector<int> my_ticket = valid_ticket_nums[0];
-    for (int j = 0; j < rules.size(); ++j) {
+    const std::vector<int> &my_ticket = notes.my_ticket;
+    for (std::size_t j = 0; j < rules.size(); ++j) {
         // Check for rule name start
-        if (rules[j].rule_name.substr(0, 9) == "departure") {
+        if (notes.rule_names.name(rules[j].rule_name).starts_with("departure")) {
             invalid_prod *= my_ticket[mapping[j]];
         }
     }
@@ -200,12 +191,22 @@ uint64_t solution2(const std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    std::vector<std::string_view> views = common::split_lines(buffer);
+    return get_notes(std::vector<std::string>(views.begin(), views.end()));
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    uint64_t num1 = solution1(lines);
-    std::cout << "Error rate in part 1: " << num1 << std::endl;
-    uint64_t num2 = solution2(lines);
-    std::cout << "Error rate in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day16
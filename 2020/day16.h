@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+#include "interner.h"
+
+
+/**
+ * Day 16 solver library, see day16.cpp for the solutions
+ */
+namespace day16 {
+
+typedef std::array<int, 2> RuleRange;
+
+// A named field rule with its two valid ranges, the name is an id into Notes::rule_names
+struct Rule {
+    common::Interner::Id rule_name;
+    RuleRange range1, range2;
+
+    Rule (common::Interner::Id name, RuleRange r1, RuleRange r2) 
+        : rule_name(name), range1(r1), range2(r2) 
+    {}
+
+    bool in_range(int num) const {
+        return (num >= range1[0] && num <= range1[1]) || (num >= range2[0] && num <= range2[1]);
+    }
+};
+
+// Field rules, our ticket and the nearby tickets
+struct Notes {
+    common::Interner rule_names;
+    std::vector<Rule> rules;
+    std::vector<int> my_ticket;
+    std::vector<std::vector<int>> nearby_tickets;
+};
+
+typedef Notes Parsed;
+typedef uint64_t Answer1;
+typedef uint64_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Error rate in part 1: ";
+const char PART2_LABEL[] = "Error rate in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day16
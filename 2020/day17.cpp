@@ -1,176 +1,157 @@
 #include <iostream>
 #include <vector>
 #include <array>
-#include <unordered_map>
+#include <algorithm>            // max
+#include <cstddef>              // ptrdiff_t
 #include <string>
+#include <string_view>
 #include <cstdint>              // types
 #include <cassert>
 
 #include "common.h"
+#include "grid.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day17.h"
 
 
+namespace day17 {
+
 // consts
-typedef std::array<int, 3> Point;
 const int NUM_SIMS = 6;
 const char ACTIVE = '#';
 const char INACTIVE = '.';
 
 
 /**
- * Simple power function, good enough for low base/exponents
- * @param base power base
- * @param exp power exponent
- * @return The base^power
- */
-uint64_t power(uint64_t base, uint64_t exp) {
-    uint64_t result = 1;
-    for (int i = 0; i < exp; ++i) {
-        result *= base;
-    }
-    return result;
-}
-
-/**
- * Boosts hash combine
- */
-struct ArrayHasher {
-    std::size_t operator()(const std::vector<int> & a) const {
-        std::size_t h = 0;
-        for (auto e : a) {
-            h ^= std::hash<int>{}(e) + 0x9e3779b9 + (h << 6) + (h >> 2); 
-        }
-        return h;
-    }   
-};
-
-typedef std::unordered_map<std::vector<int>, int, ArrayHasher> CubeMap;
-
-/**
- * Initialize the active cube points from input
+ * Get the active cells of the starting slice
  * @param lines Vector of strings, each element is a line from stdin
- * @param dim Number of dimensions
- * @return Starting active cubes
+ * @return Active (x, y) cells, first item read is (0,0)
  */
-CubeMap init_cubes(const std::vector<std::string> &lines, int dim) {
-    CubeMap active_cubes;
-
-    // Get starting cubes, set first item read as (0,0,0)
-    for (int i = 0; i < lines.size(); ++i) {
-        for (int j = 0; j < lines[i].size(); ++j) {
+std::vector<Cell> get_active_cells(const std::vector<std::string_view> &lines) {
+    std::vector<Cell> cells;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        for (std::size_t j = 0; j < lines[i].size(); ++j) {
             if (lines[i][j] == ACTIVE) { 
-                std::vector<int> point(dim, 0);
-                point[0] = j;
-                point[1] = i;
-                ++active_cubes[point]; 
+                cells.push_back({static_cast<int>(j), static_cast<int>(i)});
             }
         }
     }
-
-    return active_cubes;
+    return cells;
 }
 
 
 /**
- * Generate all neighbours for a given point
- * @param point The given point
- * @return Vector of points which are distance 1 away from given reference point
+ * Run one simulation
+ * @param volume Current cubes, 1 if active
+ * @param next Cubes after the simulation, same shape as volume
+ * @param neighbours Offsets of a cube's neighbours
  */
-std::vector<std::vector<int>> generate_neighbours(const std::vector<int> & point) {
-    std::vector<std::vector<int>> neighbours;
-    for (uint64_t i = 0; i < power(3, point.size()); ++i) {
-        std::vector<int> candidate_point;
-        int idx = i;
-        for (int j = 0; j < point.size(); ++j) {
-            candidate_point.push_back((idx % 3) + point[j] - 1);
-            idx = idx / 3;
-        }
-        if (candidate_point != point) {
-            neighbours.push_back(candidate_point);
+template <typename Volume>
+void simulate(const Volume &volume, Volume &next, const std::vector<std::ptrdiff_t> &neighbours) {
+    AOC_TIMER("day17.simulate");
+    const uint8_t *cubes = volume.data();
+    uint8_t *next_cubes = next.data();
+    volume.for_each_offset([&](std::ptrdiff_t cube) {
+        AOC_COUNT("day17.neighbours", neighbours.size());
+        int active_neighbours = 0;
+        for (const auto & n : neighbours) {
+            active_neighbours += cubes[cube + n];
         }
-    }
-    return neighbours;
+
+        // Active cube stays active if 2 or 3 neighbours are active, inactive cube becomes active if 3 are
+        next_cubes[cube] = (active_neighbours == 3 || (cubes[cube] && active_neighbours == 2)) ? 1 : 0;
+    });
 }
 
 
 /**
- * Run one simulation
- * @param active_cubes Current active cubes
- * @return Active cubes after simulation
+ * Gets the number of active cubes after all simulations
+ * @param cells Active (x, y) cells of the starting slice
+ * @return Number of active cubes
  */
-CubeMap simulate(CubeMap & active_cubes) {
-    CubeMap next_cubes;
-    CubeMap neighbour_counts;
-    for (auto & cube : active_cubes) {
-        int active_neighbours = 0;
-        // Count active neighbours of active cube
-        for (const auto & n : generate_neighbours(cube.first)) {
-            ++neighbour_counts[n];
-            if (active_cubes.find(n) != active_cubes.end()) {
-                ++active_neighbours;
-            }
-        }
+template <std::size_t Dim>
+uint64_t run_simulations(const std::vector<Cell> &cells) {
+    typedef common::GridN<uint8_t, Dim> Volume;
+
+    // Cubes activate at most one step further out per simulation, so a margin of NUM_SIMS
+    // around the starting slice holds them all. The border keeps every neighbour in memory
+    typename Volume::Index extents, start;
+    extents.fill(2 * NUM_SIMS + 1);
+    start.fill(NUM_SIMS);
+    for (const auto & cell : cells) {
+        extents[0] = std::max(extents[0], cell[0] + 2 * NUM_SIMS + 1);
+        extents[1] = std::max(extents[1], cell[1] + 2 * NUM_SIMS + 1);
+    }
+    Volume volume(extents, 1), next(extents, 1);
 
-        // Cube stays active if 2 or 3 neighbours are active, otherwise stays active
-        if (active_neighbours == 2 || active_neighbours == 3) {
-            ++next_cubes[cube.first];
-        }
+    // Get starting cubes, set first item read as (0,0,0, ...)
+    for (const auto & cell : cells) {
+        typename Volume::Index point = start;
+        point[0] += cell[0];
+        point[1] += cell[1];
+        volume[point] = 1;
     }
 
-    // Inactive cube becomes active if 3 neighbours are active
-    for (const auto & cube : neighbour_counts) {
-        if (cube.second == 3) {
-            ++next_cubes[cube.first];
-        }
+    // Simulate, swapping the volumes between simulations
+    const std::vector<std::ptrdiff_t> neighbours = volume.neighbour_offsets();
+    for (int i = 0; i < NUM_SIMS; ++i) {
+        simulate(volume, next, neighbours);
+        volume.swap(next);
     }
 
-    return next_cubes; 
+    // Number of active cubes
+    uint64_t active_cubes = 0;
+    volume.for_each_offset([&](std::ptrdiff_t cube) {active_cubes += volume.data()[cube];});
+    return active_cubes;
 }
 
 
 /**
  * Gets the number of active cubes
- * @param lines Vector of strings, each element is a line from stdin
+ * @param cells Active (x, y) cells of the starting slice
  * @return Number of active cubes
  */
-uint64_t solution1(const std::vector<std::string> &lines) {
-    // Get starting cubes, set first item read as (0,0,0, ...)
-    CubeMap active_cubes = init_cubes(lines, 3);
-
-    // Simulate
-    for (int i = 0; i < NUM_SIMS; ++i) {
-        active_cubes = simulate(active_cubes);
-    }
-    
-    // Number of active cubes
-    return active_cubes.size();
+uint64_t solution1(const std::vector<Cell> &cells) {
+    return run_simulations<3>(cells);
 }
 
 
 /**
  * Gets the number of active cubes
- * @param lines Vector of strings, each element is a line from stdin
+ * @param cells Active (x, y) cells of the starting slice
  * @return Number of active cubes
  */
-uint64_t solution2(const std::vector<std::string> &lines) {
-    // Get starting cubes, set first item read as (0,0,0, ...)
-    CubeMap active_cubes = init_cubes(lines, 4);
+uint64_t solution2(const std::vector<Cell> &cells) {
+    return run_simulations<4>(cells);
+}
 
-    // Simulate
-    for (int i = 0; i < NUM_SIMS; ++i) {
-        active_cubes = simulate(active_cubes);
-    }
-    
-    // Number of active cubes
-    return active_cubes.size();
+
+// Library API
+Parsed parse(std::string_view buffer) {
+    return get_active_cells(common::split_lines(buffer));
 }
 
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+void save_model(model_cache::Writer & writer, const Parsed & parsed) {
+    writer.put_array(parsed.data(), parsed.size());
+}
+
+Parsed load_model(model_cache::Reader & reader) {
+    model_cache::Span<Cell> cells = reader.get_array<Cell>();
+    return Parsed(cells.begin(), cells.end());
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::CachedDaySolver<Parsed, parse, solve_part1, solve_part2,
+                                                    save_model, load_model, MODEL_VERSION>>();
+}
 
-    uint64_t num1 = solution1(lines);
-    std::cout << "Active cubes in part 1: " << num1 << std::endl;
-    uint64_t num2 = solution2(lines);
-    std::cout << "Active cubes in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day17
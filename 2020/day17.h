@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 17 solver library, see day17.cpp for the solutions
+ */
+namespace day17 {
+
+// Active (x, y) cell of the starting slice
+typedef std::array<int, 2> Cell;
+
+typedef std::vector<Cell> Parsed;
+typedef uint64_t Answer1;
+typedef uint64_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Active cubes in part 1: ";
+const char PART2_LABEL[] = "Active cubes in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Binary model cache (see model_cache.h), bump MODEL_VERSION when the layout changes
+const uint32_t MODEL_VERSION = 1;
+void save_model(model_cache::Writer & writer, const Parsed & parsed);
+Parsed load_model(model_cache::Reader & reader);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day17
@@ -2,18 +2,32 @@
 #include <vector>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <cstdint>              // types
 #include <cassert>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day18.h"
 
 
+namespace day18 {
+
 // define and consts
-typedef std::variant<int64_t, std::string> Op;
 const Op LB = static_cast<Op>("(");
 const Op RB = static_cast<Op>(")");
+// Operator precedences, part 1 evaluates left to right and part 2 adds before multiplying
+const std::unordered_map<std::string, int> PART1_PRECEDENCE = {
+    {"+", 2},
+    {"*", 2},
+};
+const std::unordered_map<std::string, int> PART2_PRECEDENCE = {
+    {"+", 2},
+    {"*", 1},
+};
 
 
 /**
@@ -38,22 +52,20 @@ int64_t apply_operator(int64_t lhs, int64_t rhs, const std::string & op) {
  * @param line The input string
  * @return Vector of ops in infix order
  */
-std::vector<Op> str_to_infix(std::string line) {
+std::vector<Op> str_to_infix(std::string_view line) {
     std::vector<Op> infix;
-    std::string curr;
-    for (const std::string & val : common::split(line)) {
+    for (std::string_view curr : common::Tokenizer(line)) {
         // Left/right bracket don't have space between them
-        curr = val;
         int brack_counter = 0;
         while (true) {
             if (curr.front() == '(') {
                 infix.push_back(LB);
-                curr = curr.substr(1);
+                curr.remove_prefix(1);
             } else if (curr.back() == ')') {
                 ++brack_counter;
-                curr = curr.substr(0, curr.size() - 1);
+                curr.remove_suffix(1);
             } else {
-                infix.push_back((common::is_number(curr) ? static_cast<Op>(std::stoll(curr)) : static_cast<Op>(curr)));
+                infix.push_back((common::is_number(curr) ? static_cast<Op>(common::to_number<int64_t>(curr)) : static_cast<Op>(std::string(curr))));
                 break;
             }
         }
@@ -72,13 +84,18 @@ std::vector<Op> str_to_infix(std::string line) {
  * @param op_pres Operator precedence map
  * @return Vector of ops in postfix order
  */
-std::vector<Op> infix_to_postfix(std::vector<Op> infix, std::unordered_map<std::string, int> op_pres) {
+std::vector<Op> infix_to_postfix(const std::vector<Op> &infix, const std::unordered_map<std::string, int> &op_pres) {
     std::vector<Op> postfix;
     std::stack<Op> st;
     auto pop_and_save = [&](){
         postfix.push_back(st.top());
         st.pop();
     };
+    // Brackets have no precedence so operators never pop past them
+    auto precedence = [&](const Op & o) {
+        auto itr = op_pres.find(std::get<std::string>(o));
+        return (itr == op_pres.end()) ? 0 : itr->second;
+    };
 
     for (const auto & op : infix) {
         // Scanned op is an operand, add to output
@@ -95,7 +112,7 @@ std::vector<Op> infix_to_postfix(std::vector<Op> infix, std::unordered_map<std::
             st.pop();
         } else {
             // Scanned operator
-            while (!st.empty() && op_pres[std::get<std::string>(op)] <= op_pres[std::get<std::string>(st.top())]) {
+            while (!st.empty() && precedence(op) <= precedence(st.top())) {
                 pop_and_save();
             }
             st.push(op);
@@ -122,7 +139,7 @@ int64_t posfix_eval(std::vector<Op> ops) {
         return val;
     };
 
-    for (const auto op : ops) {
+    for (const auto & op : ops) {
         // If operand then push value to stack
         if (op.index() == 0) {
             st.push(std::get<int64_t>(op));
@@ -140,26 +157,29 @@ int64_t posfix_eval(std::vector<Op> ops) {
 
 
 /**
- * Gets the sum of resulting formula
- * @param lines Vector of strings, each element is a line from stdin
- * @return Sum of results
+ * Evaluate an expression
+ * @param infix The expression's ops in infix order
+ * @param op_pres Operator precedence map
+ * @return result of the expression
  */
-int64_t solution1(const std::vector<std::string> &lines) {
-    int64_t result = 0;
-    std::unordered_map<std::string, int> op_pres = {
-        {"+", 2},
-        {"*", 2},
-    };
+int64_t evaluate(const std::vector<Op> &infix, const std::unordered_map<std::string, int> &op_pres) {
+    // convert infix to postfix notation
+    std::vector<Op> postfix = infix_to_postfix(infix, op_pres);
 
-    for (const auto & line : lines) {
-        // Get list of ops
-        std::vector<Op> infix = str_to_infix(line);
+    // Calculate resut using postfix
+    return posfix_eval(postfix);
+}
 
-        // convert infix to postfix notation
-        std::vector<Op> postfix = infix_to_postfix(infix, op_pres);
 
-        // Calculate resut using postfix
-        result += posfix_eval(postfix);
+/**
+ * Gets the sum of resulting formula
+ * @param expressions Each expression as ops in infix order
+ * @return Sum of results
+ */
+int64_t solution1(const std::vector<std::vector<Op>> &expressions) {
+    int64_t result = 0;
+    for (const auto & infix : expressions) {
+        result += evaluate(infix, PART1_PRECEDENCE);
     }
     return result;
 }
@@ -167,36 +187,45 @@ int64_t solution1(const std::vector<std::string> &lines) {
 
 /**
  * Gets the sum of resulting formula
- * @param lines Vector of strings, each element is a line from stdin
+ * @param expressions Each expression as ops in infix order
  * @return Sum of results
  */
-int64_t solution2(const std::vector<std::string> &lines) {
+int64_t solution2(const std::vector<std::vector<Op>> &expressions) {
     int64_t result = 0;
-    std::unordered_map<std::string, int> op_pres = {
-        {"+", 2},
-        {"*", 1},
-    };
+    for (const auto & infix : expressions) {
+        result += evaluate(infix, PART2_PRECEDENCE);
+    }
+    return result;
+}
+
 
-    for (const auto & line : lines) {
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed expressions;
+    for (const auto & line : common::split_lines(buffer)) {
         // Get list of ops
-        std::vector<Op> infix = str_to_infix(line);
+        expressions.push_back(str_to_infix(line));
+        AOC_HISTOGRAM("day18.tokens", expressions.back().size());
+    }
+    return expressions;
+}
 
-        // convert infix to postfix notation
-        std::vector<Op> postfix = infix_to_postfix(infix, op_pres);
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
 
-        // Calculate resut using postfix
-        result += posfix_eval(postfix);
-    }
-    return result;
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
 }
 
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+void Stream::consume(std::string_view line) {
+    std::vector<Op> infix = str_to_infix(line);
+    sum1 += evaluate(infix, PART1_PRECEDENCE);
+    sum2 += evaluate(infix, PART2_PRECEDENCE);
+}
 
-    int64_t num1 = solution1(lines);
-    std::cout << "Sum of values in part 1: " << num1 << std::endl;
-    int64_t num2 = solution2(lines);
-    std::cout << "Sum of values in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day18
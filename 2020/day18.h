@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+#include <variant>
+
+#include "runner.h"
+
+
+/**
+ * Day 18 solver library, see day18.cpp for the solutions
+ */
+namespace day18 {
+
+// Expression token, either an operand or an operator/bracket
+typedef std::variant<int64_t, std::string> Op;
+
+// Each expression as ops in infix order
+typedef std::vector<std::vector<Op>> Parsed;
+typedef int64_t Answer1;
+typedef int64_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Sum of values in part 1: ";
+const char PART2_LABEL[] = "Sum of values in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const {return sum1;}
+    Answer2 part2() const {return sum2;}
+
+private:
+    int64_t sum1 = 0, sum2 = 0;
+};
+
+} // namespace day18
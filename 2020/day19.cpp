@@ -1,79 +1,140 @@
 #include <iostream>
 #include <vector>
-#include <deque>
 #include <unordered_set>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <optional>
 #include <regex>
 #include <algorithm>            // find
 #include <cstdint>              // types
 #include <cassert>
+#include <stdexcept>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day19.h"
 
 
+namespace day19 {
+
 // define and consts
-const std::unordered_set<std::string> NON_EXPR = {"|", "(", ")+"};
-typedef std::unordered_map<std::string, std::string> RuleMap;
+const std::unordered_set<std::string_view> NON_EXPR = {"|", "(", ")+"};
+
+
+/**
+ * Set a rule's expression, adding the rule if it's new
+ * @param rules The rules
+ * @param idx The rule's number
+ * @param expression The rule's expression
+ */
+void set_rule(Rules & rules, std::string_view idx, std::string_view expression) {
+    common::Interner::Id id = rules.ids.intern(idx);
+    if (id == rules.expressions.size()) {rules.expressions.emplace_back();}
+    rules.expressions[id] = expression;
+}
 
 
 /**
  * Get the expression rules
  * @param lines Vector of strings containing rules
- * @return Map of rule ID and rule expression
+ * @return The rule expressions, indexed by rule id
  */
-RuleMap get_rules(const std::vector<std::string> &lines) {
-    RuleMap r_map;
+Rules get_rules(const std::vector<std::string_view> &lines) {
+    Rules rules;
     for (const auto & line : lines) {
         std::size_t idx = line.find(':');
-        r_map[line.substr(0, idx)] = line.substr(idx + 2);
+        set_rule(rules, line.substr(0, idx), line.substr(idx + 2));
     }
-    return r_map;
+    return rules;
 }
 
 
 /**
- * Create the regex pattern from the input rules
- * @param rule_map The mapping of rules + idx
+ * Create the regex pattern from the input rules.
+ * Each rule is expanded once, after its child rules, by replacing all the child IDs
+ * in its expression in a single pass. A child's expansion is dropped after its last use.
+ * @param rules The rule expressions
  * @return The regex pattern which accepts all strings valid by the rules
  */
-std::regex create_regex(const RuleMap & rule_map) {
-    std::string pattern = " " + rule_map.at("0") + " ";
-    std::vector<std::string> rules = common::split(rule_map.at("0"));
-    std::deque<std::string> queue(rules.begin(), rules.end());
+std::regex create_regex(const Rules & rules) {
+    AOC_TIMER("day19.create_regex");
+    const common::Interner::Id NONE = common::Interner::NONE;
+    std::size_t num_rules = rules.expressions.size();
+    common::Interner::Id root = rules.ids.find("0");
+    if (root == NONE) {throw "Missing rule 0";}
 
     // lambdas
-    auto pop_and_return = [&]() {
-        std::string value = queue.front();
-        queue.pop_front();
-        return value;
-    };
-    auto insert_non_expr = [](std::string val) {
-        return NON_EXPR.find(val) == NON_EXPR.end();
+    auto child_id = [&](std::string_view token) {
+        if (token.front() == '"' || NON_EXPR.find(token) != NON_EXPR.end()) {return NONE;}
+        common::Interner::Id id = rules.ids.find(token);
+        if (id == NONE) {throw "Unknown rule";}
+        return id;
     };
 
-    // Exhaust all rules
-    while (!queue.empty()) {
-        const std::string & idx = pop_and_return();
-        const std::string & rule = rule_map.at(idx); 
-        
-        // If rule is not char literal, we need to add child rules
-        if (rule.find('"') == std::string::npos) {
-            // Prevent doing a child rule multiple times
-            std::unordered_set<std::string> to_add;
-            for (const auto & child_rule : common::split(rule)) {
-                if (to_add.find(child_rule) == to_add.end() && NON_EXPR.find(child_rule) == NON_EXPR.end()) {
-                    queue.push_back(child_rule);
+    // Count the uses of every rule reachable from rule 0
+    std::vector<int> uses(num_rules, 0);
+    uses[root] = 1;
+    std::vector<common::Interner::Id> stack = {root};
+    while (!stack.empty()) {
+        common::Interner::Id id = stack.back();
+        stack.pop_back();
+        for (std::string_view token : common::Tokenizer(rules.expressions[id])) {
+            common::Interner::Id child = child_id(token);
+            if (child != NONE && uses[child]++ == 0) {
+                stack.push_back(child);
+            }
+        }
+    }
+
+    // Expand the rules depth first, children before their parent
+    std::vector<std::string> expanded(num_rules);
+    std::vector<bool> visited(num_rules, false), done(num_rules, false);
+    stack = {root};
+    while (!stack.empty()) {
+        common::Interner::Id id = stack.back();
+        if (done[id]) {
+            stack.pop_back();
+            continue;
+        }
+        const std::string & rule = rules.expressions[id];
+
+        // First visit, child rules need to be expanded first
+        if (!visited[id]) {
+            visited[id] = true;
+            for (std::string_view token : common::Tokenizer(rule)) {
+                common::Interner::Id child = child_id(token);
+                if (child == NONE || done[child]) {continue;}
+                if (visited[child]) {
+                    throw "Recursive rule";
                 }
+                stack.push_back(child);
+            }
+            continue;
+        }
+
+        std::string expansion = common::replace_tokens(rule, " ", [&](std::string_view token) -> std::optional<std::string_view> {
+            common::Interner::Id child = child_id(token);
+            if (child == NONE) {return std::nullopt;}
+            return expanded[child];
+        });
+        for (std::string_view token : common::Tokenizer(rule)) {
+            common::Interner::Id child = child_id(token);
+            if (child != NONE && --uses[child] == 0) {
+                std::string().swap(expanded[child]);
             }
         }
 
-        // Replacement for any occurance of the idx is our rule
         // Need to surround | with brackets to keep order of operations
-        std::string replacement = (rule.find('|') == std::string::npos) ? rule : "( " + rule + " )";
-        pattern = common::replace(pattern, " " + idx + " ", " " + replacement + " ");
+        AOC_COUNT("day19.rule_expansions", 1);
+        expanded[id] = (rule.find('|') == std::string::npos) ? std::move(expansion) : "( " + expansion + " )";
+        done[id] = true;
+        stack.pop_back();
     }
 
+    std::string pattern = std::move(expanded[root]);
+    AOC_HISTOGRAM("day19.pattern_length", pattern.size());
+
     // Cleanup by removing quotes around char literals
     common::erase(pattern, '"');
     common::erase(pattern, ' ');
@@ -84,17 +145,18 @@ std::regex create_regex(const RuleMap & rule_map) {
 
 /**
  * Gets the number of expression matching rule
- * @param rule_map The map of expression rules
+ * @param rules The expression rules
  * @param input Vector of strings, each element is an input expression
  * @return Number of matched expressions
  */
-int solution1(RuleMap rule_map, std::vector<std::string> input) {
+int solution1(const Rules &rules, const std::vector<std::string> &input) {
     // Create regex for the rules
-    std::regex r = create_regex(rule_map);
+    std::regex r = create_regex(rules);
 
     // Check if inputs match rule
     int num_matched = 0;
     for (const auto & s : input) {
+        AOC_TIMER("day19.regex_match");
         if (std::regex_match(s, r)) {
             ++num_matched;
         }
@@ -105,21 +167,25 @@ int solution1(RuleMap rule_map, std::vector<std::string> input) {
 
 /**
  * Gets the number of expression matching rule
- * @param rule_map The map of expression rules
+ * @param rules The expression rules
  * @param input Vector of strings, each element is an input expression
  * @return Number of matched expressions
  */
-int solution2(RuleMap rule_map, std::vector<std::string> input) {
+int solution2(const Rules &rules, const std::vector<std::string> &input) {
+    // Patch a private copy, the parsed rules are shared between parts
+    Rules patched = rules;
+
     // Need to update rules for part 2
-    rule_map["8"] = "( 42 )+";
-    rule_map["11"] = "42 31 | 42 42 31 31 | 42 42 42 31 31 31 | 42 42 42 42 31 31 31 31 | 42 42 42 42 42 31 31 31 31 31";
+    set_rule(patched, "8", "( 42 )+");
+    set_rule(patched, "11", "42 31 | 42 42 31 31 | 42 42 42 31 31 31 | 42 42 42 42 31 31 31 31 | 42 42 42 42 42 31 31 31 31 31");
 
     // Create regex for the rules
-    std::regex r = create_regex(rule_map);
+    std::regex r = create_regex(patched);
 
     // Check if inputs match rule
     int num_matched = 0;
     for (const auto & s : input) {
+        AOC_TIMER("day19.regex_match");
         if (std::regex_match(s, r)) {
             ++num_matched;
         }
@@ -128,17 +194,61 @@ int solution2(RuleMap rule_map, std::vector<std::string> input) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
-
-    // Get input + rules
+// Library API
+Parsed parse(std::string_view buffer) {
+    std::vector<std::string_view> lines = common::split_lines(buffer);
     auto split_idx = std::find(lines.begin(), lines.end(), "");
-    RuleMap rule_map = get_rules(std::vector<std::string>(lines.begin(), split_idx));
-    std::vector<std::string> input(split_idx + 1, lines.end());
-
-    int num1 = solution1(rule_map, input);
-    std::cout << "Messages matching in part 1: " << num1 << std::endl;
-    int num2 = solution2(rule_map, input);
-    std::cout << "Messages matching in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+    Parsed parsed;
+    parsed.rules = get_rules(std::vector<std::string_view>(lines.begin(), split_idx));
+    if (split_idx != lines.end()) {
+        parsed.messages.assign(split_idx + 1, lines.end());
+    }
+    return parsed;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed.rules, parsed.messages);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed.rules, parsed.messages);
+}
+
+void save_model(model_cache::Writer & writer, const Parsed & parsed) {
+    std::vector<std::string_view> ids;
+    for (common::Interner::Id id = 0; id < parsed.rules.ids.size(); ++id) {
+        ids.push_back(parsed.rules.ids.name(id));
+    }
+    writer.put_strings(ids);
+    writer.put_strings(parsed.rules.expressions);
+    writer.put_strings(parsed.messages);
+}
+
+// Not in place: the interner is rebuilt and every rule and message copied to a string
+Parsed load_model(model_cache::Reader & reader) {
+    model_cache::StringTable ids = reader.get_strings();
+    model_cache::StringTable rules = reader.get_strings();
+    model_cache::StringTable messages = reader.get_strings();
+    if (ids.size() != rules.size()) {throw std::runtime_error("Corrupt model cache");}
+
+    // Interning the rule numbers in order gives back the same ids
+    Parsed parsed;
+    parsed.rules.ids.reserve(ids.size(), ids.blob.size());
+    parsed.rules.expressions.reserve(rules.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (parsed.rules.ids.intern(ids[i]) != i) {throw std::runtime_error("Corrupt model cache");}
+        parsed.rules.expressions.emplace_back(rules[i]);
+    }
+    parsed.messages.reserve(messages.size());
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        parsed.messages.emplace_back(messages[i]);
+    }
+    return parsed;
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::CachedDaySolver<Parsed, parse, solve_part1, solve_part2,
+                                                    save_model, load_model, MODEL_VERSION>>();
+}
+
+} // namespace day19
@@ -1,95 +1,114 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <algorithm>        // count
+#include <array>
+#include <algorithm>        // count, count_if
 #include <cassert>
 
 #include "common.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day2.h"
 
 
+namespace day2 {
+
 // consts
-const std::string DELIMS = " -:";
+const std::string_view DELIMS = " -:";
+
+
+/**
+ * Extract the policy numbers, letter and password from a line
+ * @param line The line, e.g. "1-3 a: abcde"
+ * @return The password policy
+ */
+Policy get_policy(std::string_view line) {
+    // Extract needed information
+    std::array<std::string_view, 4> line_data;
+    if (common::Tokenizer(line, DELIMS).fill(line_data) != line_data.size()) {throw "Invalid policy";}
+
+    AOC_HISTOGRAM("day2.password_length", line_data[3].size());
+
+    // Convert to needed format
+    return {common::to_number<int>(line_data[0]), common::to_number<int>(line_data[1]), line_data[2][0], std::string(line_data[3])};
+}
+
+
+/**
+ * Checks the password contains the required number of occurances of the rule character
+ * @param policy The password policy
+ * @return True if the password is valid
+ */
+bool is_valid1(const Policy &policy) {
+    int occurances = std::count(policy.password.begin(), policy.password.end(), policy.letter);
+    return policy.first <= occurances && occurances <= policy.second;
+}
+
+
+/**
+ * Checks the password has the rule character at exactly one of the two positions
+ * @param policy The password policy
+ * @return True if the password is valid
+ */
+bool is_valid2(const Policy &policy) {
+    size_t pos1 = policy.first - 1;
+    size_t pos2 = policy.second - 1;
+    const std::string &password = policy.password;
+
+    assert (pos1 < password.size() && pos2 < password.size());
+    return (password[pos1] == policy.letter) ^ (password[pos2] == policy.letter);
+}
 
 
 /**
- * Checks each line if the password contains the required number of occurances
+ * Checks each password contains the required number of occurances
  * for the character rule.
  * 
- * @param lines Vector of strings, each element is a line from stdin
+ * @param policies The password policies
  * @return Count of valid passwords which match their pattern requirements
  */
-int solution1(std::vector<std::string> &lines) {
-    int count = 0;
-    for (auto line : lines) {
-        size_t iter_begin = 0, iter_curr = 0;
-        std::vector<std::string> line_data;
-
-        // Extract needed information
-        while ((iter_begin = line.find_first_not_of(DELIMS, iter_curr)) != std::string::npos) {
-            iter_curr = line.find_first_of(DELIMS, iter_begin + 1);
-            line_data.push_back(line.substr(iter_begin, iter_curr - iter_begin));
-        }
-
-        // Convert to needed format
-        int min = std::stoi(line_data[0]);
-        int max = std::stoi(line_data[1]);
-        char rule = line_data[2][0];
-        std::string &password = line_data[3];
-        std::size_t occurances = std::count(password.begin(), password.end(), rule);
-
-        // Password matches rule
-        if (min <= occurances && occurances <= max) {
-            ++count;
-        }
-    }
-
-    return count;
+int solution1(const std::vector<Policy> &policies) {
+    return std::count_if(policies.begin(), policies.end(), is_valid1);
 }
 
 
 /**
- * Checks each line if the password contains the required number of occurances
- * for the character rule.
+ * Checks each password has the rule character at exactly one of the two positions
  * 
- * @param lines Vector of strings, each element is a line from stdin
+ * @param policies The password policies
  * @return Count of valid passwords which match their pattern requirements
  */
-int solution2(std::vector<std::string> &lines) {
-    int count = 0;
-    for (auto line : lines) {
-        size_t iter_begin = 0, iter_curr = 0;
-        std::vector<std::string> line_data;
-
-        // Extract needed information
-        while ((iter_begin = line.find_first_not_of(DELIMS, iter_curr)) != std::string::npos) {
-            iter_curr = line.find_first_of(DELIMS, iter_begin + 1);
-            line_data.push_back(line.substr(iter_begin, iter_curr - iter_begin));
-        }
-
-        // Convert to needed format
-        size_t pos1 = std::stoi(line_data[0]) - 1;
-        size_t pos2 = std::stoi(line_data[1]) - 1;
-        char rule = line_data[2][0];
-        std::string &password = line_data[3];
-
-        // Password matches rule
-        assert (pos1 < password.size() && pos2 < password.size());
-        if ((password[pos1] == rule) ^ (password[pos2] == rule)) {
-            ++count;
-        }
+int solution2(const std::vector<Policy> &policies) {
+    return std::count_if(policies.begin(), policies.end(), is_valid2);
+}
+
+
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed policies;
+    for (const auto & line : common::split_lines(buffer)) {
+        policies.push_back(get_policy(line));
     }
+    return policies;
+}
 
-    return count;
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
 }
 
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
+
+void Stream::consume(std::string_view line) {
+    Policy policy = get_policy(line);
+    valid1 += is_valid1(policy);
+    valid2 += is_valid2(policy);
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Number of valid passwords part 1: " << count1 << std::endl;
-    
-    int count2 = solution2(lines);
-    std::cout << "Number of valid passwords part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day2
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 2 solver library, see day2.cpp for the solutions
+ */
+namespace day2 {
+
+// A password and the policy it is checked against
+struct Policy {
+    int first, second;
+    char letter;
+    std::string password;
+};
+
+typedef std::vector<Policy> Parsed;
+typedef int Answer1;
+typedef int Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Number of valid passwords part 1: ";
+const char PART2_LABEL[] = "Number of valid passwords part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const {return valid1;}
+    Answer2 part2() const {return valid2;}
+
+private:
+    int valid1 = 0, valid2 = 0;
+};
+
+} // namespace day2
@@ -1,32 +1,53 @@
 #include <iostream>
 #include <vector>
+#include <string_view>
 #include <array>
+#include <cstdint>              // types
 #include <cassert>
 
 #include "common.h"
+#include "grid.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day3.h"
+
+
+namespace day3 {
+
+// consts
+// X/Y displacements of part 2's paths, part 1 only uses the second
+const std::array<std::array<int, 2>, 5> SLOPES = {{
+    {1, 1},
+    {3, 1},
+    {5, 1},
+    {7, 1},
+    {1, 2}
+}};
+const std::size_t PART1_SLOPE = 1;
+const char TREE = '#';
 
 
 /**
  * Given a path (represented by the X/Y offsets), counts the number of trees
  * passed along the traveled path.
  * 
- * @param lines Vector of strings, each element is a line from stdin
+ * @param map The map of trees
  * @param dx The displacement in X along which the path travels
  * @param dy The displacement in Y along which the path travels
  * @return Count of trees passed along the path
  */
-int count_trees(std::vector<std::string> &lines, int dx, int dy) {
-    assert (lines.size() > 0);
+int count_trees(const common::Grid<uint8_t> &map, int dx, int dy) {
+    // No map, no trees, and no width to wrap the column around
+    if (map.rows() == 0 || map.cols() == 0) {return 0;}
 
     int count = 0;
-    std::size_t col = dx, row = dy;
-    std::size_t height = lines.size(), width = lines[0].size();
+    int col = dx % map.cols(), row = dy;
+    int height = map.rows(), width = map.cols();
 
     while (row < height) {
+        AOC_COUNT("day3.path_steps", 1);
         // Tree, increment count
-        if (lines[row][col] == '#') {
-            ++count;
-        }
+        count += map.row(row)[col];
 
         // Update path index
         col = (col + dx) % width;
@@ -41,11 +62,11 @@ int count_trees(std::vector<std::string> &lines, int dx, int dy) {
 /**
  * Just counts the trees along a single path.
  * 
- * @param lines Vector of strings, each element is a line from stdin
+ * @param map The map of trees
  * @return Count of trees passed along the path
  */
-int solution1(std::vector<std::string> &lines) {
-    return count_trees(lines, 3, 1);
+int solution1(const common::Grid<uint8_t> &map) {
+    return count_trees(map, SLOPES[PART1_SLOPE][0], SLOPES[PART1_SLOPE][1]);
 }
 
 
@@ -54,34 +75,57 @@ int solution1(std::vector<std::string> &lines) {
  * 
  * @note Possible overflow, uses 64bit ints.
  * 
- * @param lines Vector of strings, each element is a line from stdin
+ * @param map The map of trees
  * @return Count of trees passed along the path
  */
-long long int solution2(std::vector<std::string> &lines) {
-    static const std::vector<std::array<int, 2>> offsets = 
-    {
-        {1, 1},
-        {3, 1},
-        {5, 1},
-        {7, 1},
-        {1, 2}
-    };
-    
+long long int solution2(const common::Grid<uint8_t> &map) {
     long long int count = 1;
-    for (auto const & offset : offsets) {
-        count *= count_trees(lines, offset[0], offset[1]);
+    for (auto const & slope : SLOPES) {
+        count *= count_trees(map, slope[0], slope[1]);
     }
 
     return count;
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    return common::grid_from_lines<uint8_t>(common::split_lines(buffer), [](char c) {return c == TREE;});
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
+
+// Row r of a path is reached on step r / dy, at column (r / dy * dx) % width, as in count_trees
+void Stream::consume(std::string_view line) {
+    if (row == 0) {width = line.size();}
+    assert (line.size() == width);
+    for (std::size_t i = 0; i < SLOPES.size(); ++i) {
+        std::size_t dx = SLOPES[i][0], dy = SLOPES[i][1];
+        if (row > 0 && row % dy == 0 && line[(row / dy * dx) % width] == TREE) {
+            ++trees[i];
+        }
+    }
+    ++row;
+}
+
+Answer1 Stream::part1() const {
+    return trees[PART1_SLOPE];
+}
+
+Answer2 Stream::part2() const {
+    long long int count = 1;
+    for (int t : trees) {count *= t;}
+    return count;
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Number of trees along path for part 1: " << count1 << std::endl;
-    long long int count2 = solution2(lines);
-    std::cout << "Number of trees along path for part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day3
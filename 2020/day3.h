@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <array>
+#include <cstdint>              // types
+
+#include "grid.h"
+#include "runner.h"
+
+
+/**
+ * Day 3 solver library, see day3.cpp for the solutions
+ */
+namespace day3 {
+
+// Map of the slope, a cell is 1 for a tree and 0 for open ground
+typedef common::Grid<uint8_t> Parsed;
+typedef int Answer1;
+typedef long long int Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Number of trees along path for part 1: ";
+const char PART2_LABEL[] = "Number of trees along path for part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const;
+    Answer2 part2() const;
+
+private:
+    std::size_t row = 0, width = 0;
+    std::array<int, 5> trees{};         // Per slope of day3.cpp's SLOPES
+};
+
+} // namespace day3
@@ -1,119 +1,147 @@
 #include <iostream>
-#include <sstream>
-#include <iterator>
 #include <vector>
+#include <string_view>
+#include <memory>             // allocator_arg
 #include <unordered_map>
-#include <algorithm>         // find
-#include <regex>
+#include <algorithm>         // find, all_of, count_if
+#include <charconv>          // from_chars
+#include <cctype>            // isdigit
 #include <cassert>
 
 #include "common.h"
+#include "generator.h"
+#include "arena.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day4.h"
 
 
+namespace day4 {
+
 // consts
 const std::vector<std::string> REQUIRED_TOKES = {"byr", "iyr", "eyr", "hgt", "hcl", "ecl", "pid"};
-typedef bool (*CheckFunction)(std::string);
+typedef bool (*CheckFunction)(std::string_view);
 
 
 /**
- * Gets a map of passport data filed by name
- * @param lines Vector of strings, each element is a line from stdin
- * @param i Current index in the lines vector
- * @return Map of passport data fields
+ * Gets the passport data fields
+ * @param record The passport's lines, "name:value" fields separated by spaces or newlines
+ * @param fields The field names, new names are added
+ * @return Passport data fields indexed by field id
  */
-std::unordered_map<std::string, std::string> get_passport_map(std::vector<std::string> &lines, size_t &i) {
-    std::unordered_map<std::string, std::string> passport;
-
-    // Get passport data
-    while (lines[i] != "") {
-        // Split string by space
-        std::istringstream iss(lines[i]);
-        std::vector<std::string> tokens{std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>{}};
-
-        for (const auto & item : tokens) {
-            size_t idx = item.find(':');
-            assert (idx != std::string::npos);
-            passport[item.substr(0, idx)] = item.substr(idx + 1);
-        }
-        ++i;
+Passport get_passport(std::string_view record, common::Interner & fields) {
+    // The field generator's frame only lives until the next record
+    static thread_local common::Arena arena;
+    arena.reset();
+    Passport passport(fields.size());
+
+    for (std::string_view item : common::each_field(std::allocator_arg, arena.resource(), record, " \n")) {
+        size_t idx = item.find(':');
+        assert (idx != std::string_view::npos);
+        FieldId id = fields.intern(item.substr(0, idx));
+        if (id >= passport.size()) {passport.resize(fields.size());}
+        passport[id] = item.substr(idx + 1);
     }
 
+    AOC_HISTOGRAM("day4.passport_fields", std::count_if(passport.begin(), passport.end(), [](const auto & field) {
+        return field.has_value();
+    }));
     return passport;
 }
 
+
+/**
+ * Get a passport data field
+ * @param passport The passport
+ * @param id The field id, can be Interner::NONE
+ * @return The field's value, nullptr if the passport doesn't have it
+ */
+const std::string * get_field(const Passport & passport, FieldId id) {
+    return (id < passport.size() && passport[id]) ? &*passport[id] : nullptr;
+}
+
 // --------------------------------
 // | Helper valid check functions |
 // --------------------------------
 
-bool byr_valid(std::string byr) {
+// Parse the whole field as a number, false if it isn't one
+bool to_int(std::string_view field, int &value) {
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc() && ptr == field.data() + field.size();
+}
+
+bool byr_valid(std::string_view byr) {
     // Year falls in [1920, 2002]
-    int year = std::stoi(byr);
-    return (year >= 1920 && year <= 2002);
+    int year;
+    return to_int(byr, year) && (year >= 1920 && year <= 2002);
 }
 
-bool iyr_valid(std::string iyr) {
+bool iyr_valid(std::string_view iyr) {
     // Year falls in [2010, 2020]
-    int year = std::stoi(iyr);
-    return (year >= 2010 && year <= 2020);
+    int year;
+    return to_int(iyr, year) && (year >= 2010 && year <= 2020);
 }
 
-bool eyr_valid(std::string eyr) {
+bool eyr_valid(std::string_view eyr) {
     // Year falls in [2020, 2030]
-    int year = std::stoi(eyr);
-    return (year >= 2020 && year <= 2030);
+    int year;
+    return to_int(eyr, year) && (year >= 2020 && year <= 2030);
 }
 
-bool hgt_valid(std::string hgt) {
+bool hgt_valid(std::string_view hgt) {
     // Height in range depending on cm vs in
     assert (hgt.size() >= 3);
-    std::string units = hgt.substr(hgt.size() - 2);
-    int height = std::stoi(hgt.substr(0, hgt.size() - 2));    
+    std::string_view units = hgt.substr(hgt.size() - 2);
+    int height;
+    if (!to_int(hgt.substr(0, hgt.size() - 2), height)) {return false;}
     return (units == "in" && (height >= 59 && height <= 76)) || (units == "cm" && (height >= 150 && height <= 193));
 }
 
-bool hcl_valid(std::string hcl) {
+bool hcl_valid(std::string_view hcl) {
     // Hair colour is a 6 digit hex value preceeded by #
-    static const std::string valid_hcl = "0123456789abcdef";
+    static const std::string_view valid_hcl = "0123456789abcdef";
     if (hcl.size() != 7 || hcl[0] != '#') {
         return false;
     }
     for (int i = 1; i < hcl.size(); ++i) {
-        if (valid_hcl.find(hcl[i]) == std::string::npos) {
+        if (valid_hcl.find(hcl[i]) == std::string_view::npos) {
             return false;
         }
     }
     return true;
 }
 
-bool ecl_valid(std::string ecl) {
+bool ecl_valid(std::string_view ecl) {
     // eye colour is from a predetermined list
-    static const std::vector<std::string> valid_ecl = {"amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
+    static const std::vector<std::string_view> valid_ecl = {"amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
     return std::find(valid_ecl.begin(), valid_ecl.end(), ecl) != valid_ecl.end();
 }
 
-bool pid_valid(std::string pid) {
+bool pid_valid(std::string_view pid) {
     // passport id is a 9 digit number
-    static const std::regex pattern("[0-9]+");
-    return pid.size() == 9 && std::regex_match(pid, pattern);
+    return pid.size() == 9 && std::all_of(pid.begin(), pid.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
 }
 
 
 /**
  * Counts the number of valid passports, only checks if a data field is present.
- * @param lines Vector of strings, each element is a line from stdin
+ * @param passports The field names and passport data fields
  * @return Count of valid passports
  */
-int solution1(std::vector<std::string> &lines) {
+int solution1(const Passports &passports) {
     int count = 0;
+    std::vector<FieldId> required;
+    for (const auto & token : REQUIRED_TOKES) {
+        required.push_back(passports.fields.find(token));
+    }
 
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        // Get passport data map
-        std::unordered_map<std::string, std::string> passport = get_passport_map(lines, i);
-
+    for (const auto & passport : passports.passports) {
         // Check if passport valid
         bool valid = true;
-        for (const auto & token : REQUIRED_TOKES) {
-            if (passport.find(token) == passport.end()) {
+        for (const auto & id : required) {
+            if (get_field(passport, id) == nullptr) {
                 valid = false;
                 break;
             }
@@ -127,10 +155,10 @@ int solution1(std::vector<std::string> &lines) {
 
 /**
  * Counts the number of valid passports, which follow more strict rules
- * @param lines Vector of strings, each element is a line from stdin
+ * @param passports The field names and passport data fields
  * @return Count of valid passports
  */
-int solution2(std::vector<std::string> &lines) {
+int solution2(const Passports &passports) {
     int count = 0;
     // Function map to help for easy access to data field validity checks
     static const std::unordered_map<std::string, CheckFunction> func_map {
@@ -143,15 +171,19 @@ int solution2(std::vector<std::string> &lines) {
         {"pid", &pid_valid}
     };
 
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        // Get passport data map
-        std::unordered_map<std::string, std::string> passport = get_passport_map(lines, i);
+    // Ids of the required fields, with their checks
+    std::vector<std::pair<FieldId, CheckFunction>> required;
+    for (const auto & token : REQUIRED_TOKES) {
+        required.emplace_back(passports.fields.find(token), func_map.at(token));
+    }
 
+    for (const auto & passport : passports.passports) {
         // Check if passport valid
         bool valid = true;
-        for (const auto & token : REQUIRED_TOKES) {
+        for (const auto & [id, check] : required) {
             // data field present and valid
-            if (passport.find(token) == passport.end() || !func_map.at(token)(passport[token])) {
+            const std::string *field = get_field(passport, id);
+            if (field == nullptr || !check(*field)) {
                 valid = false;
                 break;
             }
@@ -164,12 +196,30 @@ int solution2(std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    // Passports are separated by blank lines
+    Parsed passports;
+    // The required fields first, so most passports are sized once
+    for (const auto & token : REQUIRED_TOKES) {
+        passports.fields.intern(token);
+    }
+    for (std::string_view record : common::each_record(buffer)) {
+        passports.passports.push_back(get_passport(record, passports.fields));
+    }
+    return passports;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Number of valid passports in part 1: " << count1 << std::endl;
-    int count2 = solution2(lines);
-    std::cout << "Number of valid passports in part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day4
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+#include <optional>
+
+#include "runner.h"
+#include "interner.h"
+
+
+/**
+ * Day 4 solver library, see day4.cpp for the solutions
+ */
+namespace day4 {
+
+// Fields are identified by the id of their interned name
+typedef common::Interner::Id FieldId;
+// Passport data fields indexed by field id, std::nullopt where missing
+typedef std::vector<std::optional<std::string>> Passport;
+
+// Field names, and the passports' fields indexed by their id
+struct Passports {
+    common::Interner fields;
+    std::vector<Passport> passports;
+};
+
+typedef Passports Parsed;
+typedef int Answer1;
+typedef int Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Number of valid passports in part 1: ";
+const char PART2_LABEL[] = "Number of valid passports in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day4
@@ -1,18 +1,24 @@
 #include <iostream>
 #include <vector>
-#include <unordered_set>
+#include <string_view>
 #include <limits>           // numeric_limits
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day5.h"
 
 
+namespace day5 {
+
 /**
  * Find the number from string ID using char to specifiy high bit
  * @param lines Vector of strings, each element is a line from stdin
  * @param high_bit_char Char being treated as high bit
  * @return Binary space partition number
  */
-uint64_t calc_num(const std::string &id, const char high_bit_char) {
+uint64_t calc_num(std::string_view id, const char high_bit_char) {
     uint64_t num = 0;
     uint64_t mask = 0;
 
@@ -27,26 +33,30 @@ uint64_t calc_num(const std::string &id, const char high_bit_char) {
 }
 
 
-uint64_t get_row(const std::string &line) {
+uint64_t get_row(std::string_view line) {
     return calc_num(line.substr(0, 7), 'B');
 }
 
 
-uint64_t get_col(const std::string &line) {
+uint64_t get_col(std::string_view line) {
     return calc_num(line.substr(7), 'R');
 }
 
 
+uint64_t get_seat_id(std::string_view line) {
+    return get_row(line) * 8 + get_col(line);
+}
+
+
 /**
  * Find the max seat ID
- * @param lines Vector of strings, each element is a line from stdin
+ * @param seat_ids The decoded seat IDs
  * @return Maximum seat ID
  */
-long long int solution1(std::vector<std::string> &lines) {
+long long int solution1(const std::vector<long long int> &seat_ids) {
     long long int max_id = 0;
 
-    for (const auto & line : lines) {
-        long long int id = get_row(line) * 8 + get_col(line);
+    for (const auto & id : seat_ids) {
         if (id > max_id) {max_id = id;}
     }
 
@@ -56,16 +66,15 @@ long long int solution1(std::vector<std::string> &lines) {
 
 /**
  * Find the correct seat ID as defined as the missing number which is occupied by +/- 1
- * @param lines Vector of strings, each element is a line from stdin
+ * @param seat_ids The decoded seat IDs
  * @return Correct seat ID
  */
-int solution2(std::vector<std::string> &lines) {
+int solution2(const std::vector<long long int> &seat_ids) {
     long long int min_id = std::numeric_limits<int>::max(), max_id = 0;
-    std::unordered_set<long long int> ids;
+    common::FlatHashSet<long long int> ids;
 
     // Populate known seat ids
-    for (const auto & line : lines) {
-        long long int id = get_row(line) * 8 + get_col(line);
+    for (const auto & id : seat_ids) {
         ids.insert(id);
         if (id > max_id) {max_id = id;}
         if (id < min_id) {min_id = id;}
@@ -73,6 +82,7 @@ int solution2(std::vector<std::string> &lines) {
 
     // Find missing ID
     for (long long int id = min_id + 1; id < max_id; ++id) {
+        AOC_COUNT("day5.id_probes", 1);
         if (ids.find(id) == ids.end()) {
             return id;
         }
@@ -82,12 +92,44 @@ int solution2(std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed seat_ids;
+    for (const auto & line : common::split_lines(buffer)) {
+        seat_ids.push_back(get_seat_id(line));
+    }
+    return seat_ids;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
+
+void Stream::consume(std::string_view line) {
+    long long int id = get_seat_id(line);
+    if (id >= static_cast<long long int>(NUM_SEATS)) {throw "Invalid boarding pass";}
+    seen.set(id);
+    if (id > max_id) {max_id = id;}
+    if (id < min_id) {min_id = id;}
+}
+
+// Same search as solution2, over the bitset of seen IDs
+Answer2 Stream::part2() const {
+    for (long long int id = min_id + 1; id < max_id; ++id) {
+        if (!seen.test(id)) {
+            return id;
+        }
+    }
+
+    return -1;
+}
 
-    int id1 = solution1(lines);
-    std::cout << "Highest seat ID in part 1: " << id1 << std::endl;
-    int id2 = solution2(lines);
-    std::cout << "Correct seat ID in part 2: " << id2 << std::endl;
-}
\ No newline at end of file
+} // namespace day5
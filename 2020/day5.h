@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <bitset>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 5 solver library, see day5.cpp for the solutions
+ */
+namespace day5 {
+
+// Decoded seat IDs, one per boarding pass
+typedef std::vector<long long int> Parsed;
+typedef long long int Answer1;
+typedef int Answer2;
+
+// Seat IDs are 7 row bits and 3 column bits
+const std::size_t NUM_SEATS = 1 << 10;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Highest seat ID in part 1: ";
+const char PART2_LABEL[] = "Correct seat ID in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const {return max_id;}
+    Answer2 part2() const;
+
+private:
+    long long int min_id = NUM_SEATS, max_id = 0;
+    std::bitset<NUM_SEATS> seen;
+};
+
+} // namespace day5
@@ -1,46 +1,58 @@
 #include <iostream>
 #include <vector>
-#include <unordered_map>
-#include <algorithm>            // count_if
+#include <array>
+#include <algorithm>            // count, count_if
 #include <cassert>
 
 #include "common.h"
+#include "generator.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day6.h"
 
 
+namespace day6 {
 
 /**
- * Gets a map of question counts
- * @param lines Vector of strings, each element is a line from stdin
- * @param i Current index in the lines vector
- * @return Map of question counts
+ * Gets the question counts of a group
+ * @param record The group's lines, one person's answers per line
+ * @return Question counts and size of the group
  */
-std::unordered_map<char, int> get_question_map(std::vector<std::string> &lines, size_t &i) {
-    std::unordered_map<char, int> question_map;
+Group get_question_map(std::string_view record) {
+    // One person per line
+    Group group{{}, 1};
 
     // Insert new questions
-    while (lines[i] != "") {
-        for (const auto c : lines[i]) {
-            ++question_map[c];
+    for (const auto c : record) {
+        if (c == '\n') {
+            ++group.people;
+        } else if (c >= 'a' && c <= 'z') {
+            ++group.question_counts[c - 'a'];
+        } else {
+            throw "Invalid question";
         }
-        ++i;
     }
 
-    return question_map;
+    AOC_HISTOGRAM("day6.unique_questions", std::count_if(group.question_counts.begin(), group.question_counts.end(), [](int count) {
+        return count > 0;
+    }));
+    AOC_HISTOGRAM("day6.group_size", group.people);
+    return group;
 }
 
 
 /**
  * Gets the sum of unique questions
- * @param lines Vector of strings, each element is a line from stdin
+ * @param groups Question counts of each group
  * @return Sum of unique questions
  */
-long long int solution1(std::vector<std::string> &lines) {
+long long int solution1(const std::vector<Group> &groups) {
     long long int count = 0;
 
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        // Get question set
-        std::unordered_map<char, int> question_map = get_question_map(lines, i);
-        count += question_map.size();
+    for (const auto & group : groups) {
+        count += std::count_if(group.question_counts.begin(), group.question_counts.end(), [](int question_count) {
+            return question_count > 0;
+        });
     }
 
     return count;
@@ -49,32 +61,76 @@ long long int solution1(std::vector<std::string> &lines) {
 
 /**
  * Gets the sum of unique questions to which everyone answered
- * @param lines Vector of strings, each element is a line from stdin
+ * @param groups Question counts of each group
  * @return Sum of unique questions
  */
-long long int solution2(std::vector<std::string> &lines) {
+long long int solution2(const std::vector<Group> &groups) {
     long long int count = 0;
 
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        int j = i;
-        // Get question set
-        std::unordered_map<char, int> question_map = get_question_map(lines, i);
-        int number_people = i - j;
-        count += std::count_if(question_map.begin(), question_map.end(), [&](std::pair<char, int> it) {
-            return it.second == number_people;
-        });
+    for (const auto & group : groups) {
+        count += std::count(group.question_counts.begin(), group.question_counts.end(), group.people);
     }
 
     return count;
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    // Groups are separated by blank lines
+    Parsed groups;
+    for (std::string_view record : common::each_record(buffer)) {
+        groups.push_back(get_question_map(record));
+    }
+    return groups;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::DaySolver<Parsed, parse, solve_part1, solve_part2>>();
+}
+
+void Stream::consume(std::string_view line) {
+    // Groups are separated by blank lines
+    if (line.empty()) {
+        end_group();
+        return;
+    }
+    for (const auto c : line) {
+        if (c < 'a' || c > 'z') {throw "Invalid question";}
+        ++question_counts[c - 'a'];
+    }
+    ++people;
+}
+
+void Stream::end_group() {
+    if (people == 0) {return;}
+    for (int count : question_counts) {
+        any_count += count > 0;
+        all_count += count == people;
+    }
+    question_counts.fill(0);
+    people = 0;
+}
+
+// The last group has no blank line after it, it's counted on a copy
+Answer1 Stream::part1() const {
+    Stream finished = *this;
+    finished.end_group();
+    return finished.any_count;
+}
+
+Answer2 Stream::part2() const {
+    Stream finished = *this;
+    finished.end_group();
+    return finished.all_count;
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Sum of counts in part 1: " << count1 << std::endl;
-    int count2 = solution2(lines);
-    std::cout << "Sum of counts in part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day6
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <array>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 6 solver library, see day6.cpp for the solutions
+ */
+namespace day6 {
+
+// Answer counts per question 'a' to 'z' of one group
+struct Group {
+    std::array<int, 26> question_counts;
+    int people;
+};
+
+typedef std::vector<Group> Parsed;
+typedef long long int Answer1;
+typedef long long int Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Sum of counts in part 1: ";
+const char PART2_LABEL[] = "Sum of counts in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+// Streaming mode, folds over the input a line at a time in constant memory
+class Stream {
+public:
+    void consume(std::string_view line);
+    Answer1 part1() const;
+    Answer2 part2() const;
+
+private:
+    // Answer counts per question 'a' to 'z' of the group being read
+    std::array<int, 26> question_counts{};
+    int people = 0;
+    long long int any_count = 0, all_count = 0;     // Over the finished groups
+
+    void end_group();
+};
+
+} // namespace day6
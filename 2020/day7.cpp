@@ -1,110 +1,110 @@
 #include <iostream>
 #include <vector>
-#include <unordered_set>
-#include <unordered_map>
-#include <algorithm>            // std::find
-#include <regex>
+#include <string_view>
+#include <memory>               // allocator_arg
+#include <algorithm>            // std::find, min
+#include <cctype>               // isdigit
 #include <cassert>
+#include <cstdint>              // types
+#include <stdexcept>
 
 #include "common.h"
+#include "generator.h"
+#include "arena.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day7.h"
 
 
+namespace day7 {
+
 // consts
 const std::string bag_to_find = "shiny gold";
-
-// Bag struct object. Identified by bag string, but also stores the count
-struct BagCount {
-    std::string bag;
-    mutable int count;
-
-    BagCount(std::string bag, int count = 0) : bag(bag), count(count) {}
-
-    bool operator==(const BagCount & other) const {
-        return bag == other.bag;
-    }
-};
-
-// We only care about unique bag hashes
-struct BagHash {
-    size_t operator()(const BagCount & bag_count) const {
-        return std::hash<std::string>()(bag_count.bag);
-    }
-};
-
-typedef std::unordered_set<BagCount, BagHash> BagSet;
-typedef std::unordered_map<std::string, BagSet> BagMap;
+const std::string_view CONTAIN = " bags contain ";
 
 
 /**
- * Generate the bag map of every bag each bag can hold
+ * Generate the bag graph of every bag each bag can hold
  * @param lines Vector of strings, each element is a line from stdin
- * @return Map of question counts
+ * @return Bag colours, and every bag each bag can hold
  */
-BagMap generate_bag_map(std::vector<std::string> &lines) {
-    BagMap bag_map;
-    std::regex rgx("[0-9]+\\s[a-z]+\\s[a-z]+\\sbag");
+BagGraph generate_bag_graph(const std::vector<std::string_view> &lines) {
+    AOC_TIMER("day7.generate_bag_map");
+    BagGraph graph;
+    std::vector<BagSet> & contents = graph.contents;
+    // Per line scratch, the field generator's frame
+    static thread_local common::Arena arena;
+
+    // Ids are dense, so a new colour's set goes at the back
+    auto bag_id = [&](std::string_view colour) {
+        BagId id = graph.colours.intern(colour);
+        if (id == contents.size()) {contents.emplace_back();}
+        return id;
+    };
 
     for (const auto & line : lines) {
-        std::smatch match;
-        std::string s = line;
-        BagSet bags;
-        std::string current_bag = line.substr(0, line.find(" bags contain"));
-        
-        // Get all bags mentioned
-        while (std::regex_search (s, match, rgx)) {
-            std::string bag_str = match[0].str();
-            int count = stoi(bag_str.substr(0, bag_str.find(" ")));
-            int start_idx = bag_str.find(" ") + 1;
-            std::string bag = bag_str.substr(start_idx, bag_str.size() - 4 - start_idx);
-            bags.insert({bag, count});
-            s = match.suffix().str();
-        }
+        arena.reset();
+        std::string_view current_bag = line.substr(0, line.find(CONTAIN));
+        std::string_view contents_text = line.substr(std::min(current_bag.size() + CONTAIN.size(), line.size()));
+        BagId outer = bag_id(current_bag);
+
+        // Get all bags mentioned, e.g. "1 bright white bag, 2 muted yellow bags."
+        for (std::string_view item : common::each_field(std::allocator_arg, arena.resource(), contents_text, ",.")) {
+            item.remove_prefix(std::min(item.find_first_not_of(' '), item.size()));
+            std::size_t count_end = item.find(' ');
+            std::size_t name_end = item.rfind(" bag");
+            // "no other bags"
+            if (item.empty() || !std::isdigit(static_cast<unsigned char>(item[0]))) {continue;}
+            if (count_end == std::string_view::npos || name_end == std::string_view::npos || name_end <= count_end) {
+                throw "Invalid bag rule";
+            }
+            AOC_COUNT("day7.inner_bags", 1);
 
-        // Store top-level mappings
-        for (const auto & b : bags) {
-            bag_map[current_bag].insert(b);
+            // Store top-level mappings
+            int count = common::to_number<int>(item.substr(0, count_end));
+            BagId inner = bag_id(item.substr(count_end + 1, name_end - count_end - 1));
+            contents[outer].try_emplace(inner, count);
         }
-
     }
 
     // Consolidate the bag groupings
     // If an inner bag contains the outer, add all the outer bag's children to the inner bag
-    for (auto outer_bag : bag_map) {
-        for (auto & inner_bag : bag_map) {
-            if (inner_bag.first == outer_bag.first) {continue;}
+    // Only other bags' sets change while an outer bag is visited, so it needn't be copied
+    for (BagId outer = 0; outer < contents.size(); ++outer) {
+        if (contents[outer].empty()) {continue;}
+        for (BagId inner = 0; inner < contents.size(); ++inner) {
+            if (inner == outer) {continue;}
+            AOC_COUNT("day7.consolidation_checks", 1);
             // Inner bag contains outer bag
-            auto itr = inner_bag.second.find((BagCount){outer_bag.first, 1});
-            if (itr != inner_bag.second.end()) {
-                for (const auto & b : outer_bag.second) {
-                    // If new bag than insert, otherwise we add to existing coun
-                    BagSet::iterator itr2 = inner_bag.second.find((BagCount){b.bag, 1});
-                    if (itr2 == inner_bag.second.end()) {
-                        inner_bag.second.insert({b.bag, b.count * itr->count});
-                    }
-                    else {
-                        itr2->count += b.count * itr->count;
-                    }
+            auto itr = contents[inner].find(outer);
+            if (itr != contents[inner].end()) {
+                // Copied, inserting into the inner bag's set can move its elements
+                int multiplier = itr->second;
+                for (const auto & [bag, count] : contents[outer]) {
+                    // New bags start at 0, otherwise we add to the existing count
+                    contents[inner][bag] += count * multiplier;
                 }
             }
         }
     }
 
-    return bag_map;
+    return graph;
 }
 
 
 /**
  * Gets the number of bags which can eventually hold a gold bag
- * @param lines Vector of strings, each element is a line from stdin
+ * @param graph Every bag each bag can hold
  * @return Number of bags
  */
-long long int solution1(std::vector<std::string> &lines) {
+long long int solution1(const BagGraph &graph) {
     long long int count = 0;
-    BagMap bag_map = generate_bag_map(lines);
+    BagId gold_bag = graph.colours.find(bag_to_find);
+    if (gold_bag == common::Interner::NONE) {return count;}
 
     // Count number of bags which contain shiny gold bag
-    for (const auto & bag : bag_map) {
-        if (bag.second.find({bag_to_find, 0}) != bag.second.end()) {
+    for (const auto & bag_set : graph.contents) {
+        if (bag_set.contains(gold_bag)) {
             ++count;
         }
     }
@@ -115,29 +115,78 @@ long long int solution1(std::vector<std::string> &lines) {
 
 /**
  * Gets the number of bags inside the gold shiny bag
- * @param lines Vector of strings, each element is a line from stdin
+ * @param graph Every bag each bag can hold
  * @return Number of bags
  */
-long long int solution2(std::vector<std::string> &lines) {
+long long int solution2(const BagGraph &graph) {
     long long int count = 0;
-    BagMap bag_map = generate_bag_map(lines);
+    BagId gold_bag = graph.colours.find(bag_to_find);
+    if (gold_bag == common::Interner::NONE) {return count;}
 
     // Count number of bags which contain shiny gold bag
-    for (const auto & bag_count : bag_map[bag_to_find]) {
-        std::cout << bag_count.bag << " " << bag_count.count << std::endl;
-        count += bag_count.count;
+    for (const auto & bag_count : graph.contents[gold_bag]) {
+        count += bag_count.second;
     }
 
     return count;
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    return generate_bag_graph(common::split_lines(buffer));
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+// Cached form of one bag graph edge, bags are ids into the colour table
+struct CachedEdge {
+    uint32_t outer, inner;
+    int32_t count;
+};
+
+void save_model(model_cache::Writer & writer, const Parsed & parsed) {
+    std::vector<std::string_view> colours;
+    std::vector<CachedEdge> edges;
+    for (BagId outer = 0; outer < parsed.contents.size(); ++outer) {
+        colours.push_back(parsed.colours.name(outer));
+        for (const auto & [inner, count] : parsed.contents[outer]) {
+            edges.push_back({outer, inner, count});
+        }
+    }
+
+    writer.put_strings(colours);
+    writer.put_array(edges.data(), edges.size());
+}
+
+// Not in place: the interner and every bag's map are rebuilt, so a load allocates per bag
+Parsed load_model(model_cache::Reader & reader) {
+    model_cache::StringTable colours = reader.get_strings();
+    model_cache::Span<CachedEdge> edges = reader.get_array<CachedEdge>();
+
+    // Interning the colours in order gives back the same ids
+    Parsed graph;
+    graph.colours.reserve(colours.size(), colours.blob.size());
+    for (std::size_t i = 0; i < colours.size(); ++i) {
+        if (graph.colours.intern(colours[i]) != i) {throw std::runtime_error("Corrupt model cache");}
+    }
+    graph.contents.resize(colours.size());
+    for (const auto & edge : edges) {
+        if (edge.outer >= colours.size() || edge.inner >= colours.size()) {throw std::runtime_error("Corrupt model cache");}
+        graph.contents[edge.outer].try_emplace(edge.inner, edge.count);
+    }
+    return graph;
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::CachedDaySolver<Parsed, parse, solve_part1, solve_part2,
+                                                    save_model, load_model, MODEL_VERSION>>();
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Sum of bags in part 1: " << count1 << std::endl;
-    int count2 = solution2(lines);
-    std::cout << "Sum of bags in part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day7
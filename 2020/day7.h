@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+#include "interner.h"
+#include "flat_hash_map.h"
+
+
+/**
+ * Day 7 solver library, see day7.cpp for the solutions
+ */
+namespace day7 {
+
+// Bags are identified by the id of their interned colour
+typedef common::Interner::Id BagId;
+// Every bag a bag can eventually hold, with counts
+typedef common::FlatHashMap<BagId, int> BagSet;
+
+// Bag colours, and the bags each bag can eventually hold, indexed by bag id
+struct BagGraph {
+    common::Interner colours;
+    std::vector<BagSet> contents;
+};
+
+typedef BagGraph Parsed;
+typedef long long int Answer1;
+typedef long long int Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "Sum of bags in part 1: ";
+const char PART2_LABEL[] = "Sum of bags in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Binary model cache (see model_cache.h), bump MODEL_VERSION when the layout changes
+const uint32_t MODEL_VERSION = 2;
+void save_model(model_cache::Writer & writer, const Parsed & parsed);
+Parsed load_model(model_cache::Reader & reader);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day7
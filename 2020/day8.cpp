@@ -1,47 +1,75 @@
 #include <iostream>
-#include <sstream>
-#include <iterator>
 #include <array>
 #include <vector>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <unordered_map>
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day8.h"
+
+
+namespace day8 {
+
+// consts
+const std::unordered_map<std::string, OP> str_op_map = {
+    {"acc", OP::ACC},
+    {"jmp", OP::JMP},
+    {"nop", OP::NOP},
+};
+
+
+/**
+ * Decode an instruction line
+ * @param line The line, e.g. "jmp -3"
+ * @return The instruction
+ */
+Instruction get_instruction(std::string_view line) {
+    // Split string by space
+    std::array<std::string_view, 2> tokens;
+    if (common::Tokenizer(line).fill(tokens) != tokens.size() || tokens[1].size() < 2) {throw "Invalid instruction";}
+
+    int dir = (tokens[1][0] == '+') ? 1 : -1;
+    auto op = str_op_map.find(std::string(tokens[0]));
+    if (op == str_op_map.end()) {throw "Invalid instruction";}
+    return {op->second, dir * common::to_number<int>(tokens[1].substr(1))};
+}
 
 
 /**
  * Runs the program, and terminates if a loop is found or the program terminates
- * @param lines Vector of strings, each element is a line from stdin
+ * @param program The decoded instructions
  * @param loop_flag reference to store whether returned value signifies accumulator or loop
+ * @param instruction_tracker Set of the executed instructions, cleared first
  * @return The accumulator count before repetition
  */
-long long int run_program(std::vector<std::string> &lines, int &loop_flag) {
+long long int run_program(const std::vector<Instruction> &program, int &loop_flag, common::FlatHashSet<std::size_t> &instruction_tracker) {
+    AOC_TIMER("day8.run_program");
     long long int accumulator = 0;
-    std::unordered_set<std::size_t> instruction_tracker;
+    instruction_tracker.clear();
     std::size_t i = 0;
     loop_flag = 0;
 
-    while (i < lines.size()) {
-        // Split string by space
-        std::istringstream iss(lines[i]);
-        std::vector<std::string> tokens{std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>{}};
+    while (i < program.size()) {
+        AOC_COUNT("day8.instructions_executed", 1);
+        const Instruction & instruction = program[i];
 
         // Check if repeated instruction, and store
-        if (instruction_tracker.find(i) != instruction_tracker.end()) {
+        if (!instruction_tracker.insert(i).second) {
             loop_flag = 1;
             return accumulator;
         }
-        instruction_tracker.insert(i);
 
         // Handle instruction type
-        if (tokens[0] == "acc") {
+        if (instruction.op == OP::ACC) {
             // Accumulate by given amount
-            int dir = (tokens[1][0] == '+') ? 1 : -1;
-            accumulator += (dir * std::stoi(tokens[1].substr(1)));
-        } else if (tokens[0] == "jmp") {
+            accumulator += instruction.arg;
+        } else if (instruction.op == OP::JMP) {
             // Jump forward/backward to instruction
-            int dir = (tokens[1][0] == '+') ? 1 : -1;
-            i += (dir * std::stoi(tokens[1].substr(1))) - 1;           
+            i += instruction.arg - 1;
         }
         ++i;
     }
@@ -51,12 +79,13 @@ long long int run_program(std::vector<std::string> &lines, int &loop_flag) {
 
 /**
  * Gets the accumulator count before code execution repeats
- * @param lines Vector of strings, each element is a line from stdin
+ * @param program The decoded instructions
  * @return The accumulator count before repetition
  */
-long long int solution1(std::vector<std::string> &lines) {
+long long int solution1(const std::vector<Instruction> &program) {
     int loop_flag = 0;
-    long long int accumulator = run_program(lines, loop_flag);
+    common::FlatHashSet<std::size_t> instruction_tracker;
+    long long int accumulator = run_program(program, loop_flag, instruction_tracker);
 
     // We expect the program to hit a loop
     if (!loop_flag) {throw "Expected loop";}
@@ -66,30 +95,34 @@ long long int solution1(std::vector<std::string> &lines) {
 
 /**
  * Changes one NOP to JMP or vise-versa so that the program eventually terminates
- * @param lines Vector of strings, each element is a line from stdin
+ * @param program The decoded instructions
  * @return The accumulator count before repetition
  */
-long long int solution2(std::vector<std::string> &lines) {
+long long int solution2(const std::vector<Instruction> &program) {
     int loop_flag = 0;
     long long int accumulator = 0;
-    const std::string str_nop = "nop", str_jmp = "jmp";
-    std::size_t index;
-    std::vector<std::array<std::string, 2>> swaps = {
-        {str_nop, str_jmp},
-        {str_jmp, str_nop},
-    };
+    // Shared by every run, so its slots are only allocated once
+    common::FlatHashSet<std::size_t> instruction_tracker;
+    const std::array<std::array<OP, 2>, 2> swaps = {{
+        {OP::NOP, OP::JMP},
+        {OP::JMP, OP::NOP},
+    }};
+
+    // Patch a private copy, the parsed program is shared between parts
+    std::vector<Instruction> patched = program;
     
     // Trivially try each change NOP/JMP
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        std::string & line = lines[i];
+    for (std::size_t i = 0; i < patched.size(); ++i) {
+        OP & op = patched[i].op;
         // Try each swapping rule
         for (const auto & swap : swaps) {
-            const std::string & from = swap[0], & to = swap[1];
-            // Line contains swap rule
-            if ((index = line.find(from)) != std::string::npos) {
-                line.replace(index, from.size(), to);
-                accumulator = run_program(lines, loop_flag);
-                line.replace(index, to.size(), from);
+            const OP from = swap[0], to = swap[1];
+            // Instruction matches swap rule
+            if (op == from) {
+                AOC_COUNT("day8.candidate_patches", 1);
+                op = to;
+                accumulator = run_program(patched, loop_flag, instruction_tracker);
+                op = from;
                 if (!loop_flag) {
                     return accumulator;
                 }
@@ -101,12 +134,35 @@ long long int solution2(std::vector<std::string> &lines) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed program;
+    for (const auto & line : common::split_lines(buffer)) {
+        program.push_back(get_instruction(line));
+    }
+    return program;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed);
+}
+
+void save_model(model_cache::Writer & writer, const Parsed & parsed) {
+    writer.put_array(parsed.data(), parsed.size());
+}
+
+Parsed load_model(model_cache::Reader & reader) {
+    model_cache::Span<Instruction> program = reader.get_array<Instruction>();
+    return Parsed(program.begin(), program.end());
+}
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<runner::CachedDaySolver<Parsed, parse, solve_part1, solve_part2,
+                                                    save_model, load_model, MODEL_VERSION>>();
+}
 
-    int count1 = solution1(lines);
-    std::cout << "Accumulator count in part 1: " << count1 << std::endl;
-    int count2 = solution2(lines);
-    std::cout << "Accumulator count in part 2: " << count2 << std::endl;
-}
\ No newline at end of file
+} // namespace day8
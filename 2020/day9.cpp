@@ -2,11 +2,17 @@
 #include <array>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 #include "common.h"
+#include "flat_hash_map.h"
+#include "runner.h"
+#include "instrument.h"
+#include "day9.h"
 
 
+namespace day9 {
+
 // consts
 const size_t BUFFER_SZ = 25;
 
@@ -16,7 +22,8 @@ const size_t BUFFER_SZ = 25;
  * @param sum_map Reference to map to fill
  * @param buffer Items to sum
  */
-void set_sum_pair(std::unordered_map<std::size_t, int> &sum_map, std::array<long long int, BUFFER_SZ> &buffer) {
+void set_sum_pair(common::FlatHashMap<std::size_t, int> &sum_map, std::array<long long int, BUFFER_SZ> &buffer) {
+    AOC_COUNT("day9.sum_map_rebuilds", 1);
     sum_map.clear();
     for (std::size_t i = 0; i < BUFFER_SZ; ++i) {
         for (std::size_t j = 0; j < BUFFER_SZ; ++j) {
@@ -30,24 +37,24 @@ void set_sum_pair(std::unordered_map<std::size_t, int> &sum_map, std::array<long
 
 /**
  * Finds the first occurance of a number which doesn't follow the 25 sum rule
- * @param lines Vector of strings, each element is a line from stdin
+ * @param numbers The input numbers
  * @return The first number which doesn't follow the rule
  */
-std::size_t solution1(std::vector<std::string> &lines) {
+std::size_t solution1(const std::vector<long long int> &numbers) {
     std::array<long long int, BUFFER_SZ> buffer;
-    std::unordered_map<std::size_t, int> sum_map;
+    common::FlatHashMap<std::size_t, int> sum_map;
 
     // Populate buffer
     for (std::size_t i = 0; i < BUFFER_SZ; ++i) {
-        buffer[i] = std::stoll(lines[i]);
+        buffer[i] = numbers[i];
     }
 
     // Populate pair sum map
     set_sum_pair(sum_map, buffer);
 
     // Check for input which doesn't follow rule
-    for (std::size_t i = BUFFER_SZ; i < lines.size(); ++i) {
-        size_t num = std::stoll(lines[i]);
+    for (std::size_t i = BUFFER_SZ; i < numbers.size(); ++i) {
+        size_t num = numbers[i];
         // Found occurance which isn't a pair sum
         if (sum_map.find(num) == sum_map.end()) {
             return num;
@@ -65,20 +72,21 @@ std::size_t solution1(std::vector<std::string> &lines) {
 
 /**
  * Finds the sum of smallest/largest of contiguous set which sums to target
- * @param lines Vector of strings, each element is a line from stdin
+ * @param numbers The input numbers
  * @param target The target sum to find
  * @return The sum of smallest + largest in list summing to target
  */
-std::size_t solution2(std::vector<std::string> &lines, std::size_t target) {
-    for (std::size_t start = 0; start < lines.size() - 1; ++start) {
+std::size_t solution2(const std::vector<long long int> &numbers, std::size_t target) {
+    for (std::size_t start = 0; start + 1 < numbers.size(); ++start) {
         std::size_t end = start + 1;
-        std::size_t sum = std::stoll(lines[start]);
+        std::size_t sum = numbers[start];
 
         // Continue until we find sum or reach end of input
-        while (sum < target && end < lines.size()) {
-            sum += std::stoll(lines[end]);
+        while (sum < target && end < numbers.size()) {
+            AOC_COUNT("day9.window_extensions", 1);
+            sum += numbers[end];
             if (sum == target) {
-                return std::stoll(lines[start]) + std::stoll(lines[end]);
+                return numbers[start] + numbers[end];
             }
             ++end;
         }
@@ -87,12 +95,59 @@ std::size_t solution2(std::vector<std::string> &lines, std::size_t target) {
 }
 
 
-int main() {
-    // Get data from stdin
-    std::vector<std::string> lines = common::read_stdin_lines();
+// Library API
+Parsed parse(std::string_view buffer) {
+    Parsed numbers;
+    for (const auto & line : common::split_lines(buffer)) {
+        numbers.push_back(common::to_number<long long int>(line));
+    }
+    if (numbers.size() < BUFFER_SZ) {throw "Input shorter than the preamble";}
+    return numbers;
+}
+
+Answer1 solve_part1(const Parsed & parsed) {
+    return solution1(parsed);
+}
+
+Answer2 solve_part2(const Parsed & parsed) {
+    return solution2(parsed, solution1(parsed));
+}
+
+
+/**
+ * Runner entry point, part 2 reuses the part 1 result as its target if it's already known
+ */
+struct Solver : runner::Solver {
+    Parsed numbers;
+    std::size_t target = 0;
+    bool has_target = false;
+
+    void parse(std::string_view input) override {
+        numbers = day9::parse(input);
+        has_target = false;
+    }
+
+    std::string part1() override {
+        target = solve_part1(numbers);
+        has_target = true;
+        return std::to_string(target);
+    }
+
+    std::string part2() override {
+        if (!has_target) {
+            target = solve_part1(numbers);
+            has_target = true;
+        }
+        return std::to_string(solution2(numbers, target));
+    }
+
+    std::unique_ptr<runner::Solver> clone() const override {
+        return std::make_unique<Solver>(*this);
+    }
+};
+
+std::unique_ptr<runner::Solver> make_solver() {
+    return std::make_unique<Solver>();
+}
 
-    std::size_t num1 = solution1(lines);
-    std::cout << "First occurance not matching rule in part 1: " << num1 << std::endl;
-    std::size_t num2 = solution2(lines, num1);
-    std::cout << "Sum of first/last in part 2: " << num2 << std::endl;
-}
\ No newline at end of file
+} // namespace day9
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>              // types
+
+#include "runner.h"
+
+
+/**
+ * Day 9 solver library, see day9.cpp for the solutions
+ */
+namespace day9 {
+
+// Input numbers
+typedef std::vector<long long int> Parsed;
+typedef std::size_t Answer1;
+typedef std::size_t Answer2;
+
+// Answer labels of the standalone executable
+const char PART1_LABEL[] = "First occurance not matching rule in part 1: ";
+const char PART2_LABEL[] = "Sum of first/last in part 2: ";
+
+// Bump when a change alters the answers, so cached results (result_cache.h) are not reused
+const uint32_t SOLVER_VERSION = 1;
+
+/**
+ * Parse the puzzle input
+ * @param buffer The whole input
+ * @return The parsed input
+ */
+Parsed parse(std::string_view buffer);
+
+Answer1 solve_part1(const Parsed & parsed);
+Answer2 solve_part2(const Parsed & parsed);
+
+// Type-erased solver for the runner and benchmark
+std::unique_ptr<runner::Solver> make_solver();
+
+} // namespace day9
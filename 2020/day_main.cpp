@@ -0,0 +1,48 @@
+#include <iostream>
+#include <exception>
+#include <string_view>
+#include <unistd.h>             // STDIN_FILENO
+
+#include "common.h"
+#include "line_reader.h"
+#include AOC_DAY_HEADER
+
+
+/**
+ * Standalone executable for a single day, reads the input from stdin and prints both answers.
+ * Built once per day against that day's solver library, AOC_DAY names the day's namespace.
+ * Days built with AOC_DAY_STREAMING also accept --stream, folding over stdin in constant memory.
+ */
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    using namespace AOC_DAY;
+
+    try {
+#ifdef AOC_DAY_STREAMING
+        if (argc > 1 && std::string_view(argv[1]) == "--stream") {
+            common::LineReader reader(STDIN_FILENO);
+            Stream stream;
+            std::string_view line;
+            while (reader.next(line)) {
+                stream.consume(line);
+            }
+
+            std::cout << PART1_LABEL << stream.part1() << std::endl;
+            std::cout << PART2_LABEL << stream.part2() << std::endl;
+            return 0;
+        }
+#endif
+        common::Input input = common::Input::from_stdin();
+        Parsed parsed = parse(input.view());
+
+        Answer1 answer1 = solve_part1(parsed);
+        std::cout << PART1_LABEL << answer1 << std::endl;
+        Answer2 answer2 = solve_part2(parsed);
+        std::cout << PART2_LABEL << answer2 << std::endl;
+    } catch (const std::exception & e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    } catch (const char *e) {
+        std::cerr << "Error: " << e << std::endl;
+        return 1;
+    }
+}
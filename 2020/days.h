@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "runner.h"
+#include "day1.h"
+#include "day2.h"
+#include "day3.h"
+#include "day4.h"
+#include "day5.h"
+#include "day6.h"
+#include "day7.h"
+#include "day8.h"
+#include "day9.h"
+#include "day10.h"
+#include "day11.h"
+#include "day12.h"
+#include "day13.h"
+#include "day14.h"
+#include "day15.h"
+#include "day16.h"
+#include "day17.h"
+#include "day18.h"
+#include "day19.h"
+
+
+// Every 2020 day, each one's library exposes a factory for its solver
+#define AOC_2020_DAYS(X) \
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) \
+    X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19)
+
+#define FACTORY_ENTRY(N) &day##N::make_solver,
+inline const std::vector<runner::SolverFactory> FACTORIES = {AOC_2020_DAYS(FACTORY_ENTRY)};
+#undef FACTORY_ENTRY
+
+#define VERSION_ENTRY(N) day##N::SOLVER_VERSION,
+inline const std::vector<uint32_t> SOLVER_VERSIONS = {AOC_2020_DAYS(VERSION_ENTRY)};
+#undef VERSION_ENTRY
+
+#ifndef AOC_DATA_DIR
+#define AOC_DATA_DIR "data/2020"
+#endif
@@ -0,0 +1,648 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <random>
+#include <algorithm>            // shuffle, min, max
+#include <numeric>              // iota
+#include <string_view>
+#include <cstdint>              // types
+#include <cstddef>              // ptrdiff_t
+#include <cstdlib>
+
+#include "common.h"
+#include "grid.h"
+
+
+/**
+ * Synthetic input generators, one per day. Every generator produces an input which
+ * the corresponding solver accepts and which has a solution for both parts, with N
+ * controlling the size. Output is deterministic for a given seed.
+ */
+
+// Generator parameters
+struct Params {
+    uint64_t n;
+    uint64_t m;
+    std::mt19937_64 rng;
+
+    // Uniform random integer in [lo, hi]
+    int64_t uniform(int64_t lo, int64_t hi) {
+        return std::uniform_int_distribution<int64_t>(lo, hi)(rng);
+    }
+
+    // True with probability p
+    bool chance(double p) {
+        return std::uniform_real_distribution<double>(0, 1)(rng) < p;
+    }
+
+    char letter() {
+        return 'a' + uniform(0, 25);
+    }
+};
+
+typedef void (*Generator)(std::ostream &, Params &);
+
+
+/**
+ * Encode an index as a lowercase word, so large N still get unique names
+ * @param idx The index to encode
+ * @return The encoded word, at least 3 letters
+ */
+std::string index_word(uint64_t idx) {
+    std::string word;
+    do {
+        word.push_back('a' + idx % 26);
+        idx /= 26;
+    } while (idx > 0 || word.size() < 3);
+    return word;
+}
+
+
+// N numbers, with exactly one planted pair and one planted triple summing to 2020
+void generate_day1(std::ostream & out, Params & p) {
+    std::vector<int64_t> nums;
+    int64_t a = p.uniform(1, 2019);
+    int64_t c = p.uniform(1, 2017), d = p.uniform(1, 2018 - c);
+    for (int64_t v : {a, 2020 - a, c, d, 2020 - c - d}) {nums.push_back(v);}
+    // Everything else is too large to take part in a sum
+    while (nums.size() < p.n) {
+        nums.push_back(p.uniform(2021, 1000000000));
+    }
+    std::shuffle(nums.begin(), nums.end(), p.rng);
+    for (const auto & num : nums) {out << num << '\n';}
+}
+
+
+// N password policy lines
+void generate_day2(std::ostream & out, Params & p) {
+    for (uint64_t i = 0; i < p.n; ++i) {
+        int len = p.uniform(5, 20);
+        int lo = p.uniform(1, len - 1), hi = p.uniform(lo + 1, len);
+        char rule = p.letter();
+        std::string password;
+        for (int j = 0; j < len; ++j) {
+            password.push_back(p.chance(0.3) ? rule : p.letter());
+        }
+        out << lo << '-' << hi << ' ' << rule << ": " << password << '\n';
+    }
+}
+
+
+// N rows of M (default 31) columns
+void generate_day3(std::ostream & out, Params & p) {
+    uint64_t cols = p.m ? p.m : 31;
+    std::string row(cols, '.');
+    for (uint64_t i = 0; i < p.n; ++i) {
+        for (auto & c : row) {c = p.chance(0.25) ? '#' : '.';}
+        out << row << '\n';
+    }
+}
+
+
+// N passports, a mix of missing, invalid and valid fields
+void generate_day4(std::ostream & out, Params & p) {
+    static const std::vector<std::string> ecl = {"amb", "blu", "brn", "gry", "grn", "hzl", "oth", "xyz"};
+    static const char hex[] = "0123456789abcdef";
+    for (uint64_t i = 0; i < p.n; ++i) {
+        std::vector<std::string> fields = {
+            "byr:" + std::to_string(p.uniform(1910, 2010)),
+            "iyr:" + std::to_string(p.uniform(2005, 2025)),
+            "eyr:" + std::to_string(p.uniform(2015, 2035)),
+            p.chance(0.5) ? "hgt:" + std::to_string(p.uniform(140, 200)) + "cm" : "hgt:" + std::to_string(p.uniform(55, 80)) + "in",
+            "ecl:" + ecl[p.uniform(0, ecl.size() - 1)],
+            "pid:" + std::to_string(p.uniform(p.chance(0.9) ? 100000000 : 1000, 999999999)),
+            "cid:" + std::to_string(p.uniform(100, 350)),
+        };
+        std::string hcl = "hcl:#";
+        for (int j = 0; j < 6; ++j) {hcl.push_back(hex[p.uniform(0, 15)]);}
+        fields.push_back(hcl);
+
+        // Drop a field now and again, then spread the rest over a few lines
+        if (p.chance(0.2)) {fields.erase(fields.begin() + p.uniform(0, fields.size() - 1));}
+        std::shuffle(fields.begin(), fields.end(), p.rng);
+        for (std::size_t j = 0; j < fields.size(); ++j) {
+            out << fields[j] << (j + 1 == fields.size() || p.chance(0.3) ? '\n' : ' ');
+        }
+        if (i + 1 < p.n) {out << '\n';}
+    }
+}
+
+
+// N boarding passes over a contiguous block of seats with one gap, repeating seats if N > 1022
+void generate_day5(std::ostream & out, Params & p) {
+    uint64_t seats = std::max<uint64_t>(3, std::min<uint64_t>(p.n, 1022));
+    int first = p.uniform(1, 1024 - seats - 1);
+    int missing = first + p.uniform(1, seats - 1);
+    std::vector<int> ids;
+    for (int id = first; id <= first + static_cast<int>(seats); ++id) {
+        if (id != missing) {ids.push_back(id);}
+    }
+    std::shuffle(ids.begin(), ids.end(), p.rng);
+
+    for (uint64_t i = 0; i < std::max<uint64_t>(p.n, ids.size()); ++i) {
+        int id = ids[i % ids.size()];
+        std::string pass;
+        for (int bit = 9; bit >= 3; --bit) {pass.push_back((id >> bit) & 1 ? 'B' : 'F');}
+        for (int bit = 2; bit >= 0; --bit) {pass.push_back((id >> bit) & 1 ? 'R' : 'L');}
+        out << pass << '\n';
+    }
+}
+
+
+// N groups of 1-5 people
+void generate_day6(std::ostream & out, Params & p) {
+    for (uint64_t i = 0; i < p.n; ++i) {
+        int people = p.uniform(1, 5);
+        for (int j = 0; j < people; ++j) {
+            std::string answers;
+            for (char c = 'a'; c <= 'z'; ++c) {
+                if (p.chance(0.4)) {answers.push_back(c);}
+            }
+            out << (answers.empty() ? "a" : answers) << '\n';
+        }
+        if (i + 1 < p.n) {out << '\n';}
+    }
+}
+
+
+// N-node bag DAG, shiny gold sits near the end so it has many ancestors but a bounded subtree
+void generate_day7(std::ostream & out, Params & p) {
+    static const std::vector<std::string> colours = {"red", "orange", "yellow", "green", "blue", "indigo", "violet", "white", "black", "tan"};
+    uint64_t n = std::max<uint64_t>(p.n, 2);
+    uint64_t gold = n - std::min<uint64_t>(n - 1, 10) - 1;
+    std::vector<std::string> names;
+    for (uint64_t i = 0; i < n; ++i) {
+        names.push_back(i == gold ? "shiny gold" : index_word(i / colours.size()) + " " + colours[i % colours.size()]);
+    }
+
+    // Bags only hold bags with a larger index, which keeps the graph acyclic
+    for (uint64_t i = 0; i < n; ++i) {
+        uint64_t remaining = n - i - 1;
+        // Gold holds at least one bag, so part 2 isn't 0
+        int children = std::min<uint64_t>(remaining, p.uniform(i == gold ? 1 : 0, i > gold ? 2 : 4));
+        out << names[i] << " bags contain ";
+        if (children == 0) {
+            out << "no other bags.\n";
+            continue;
+        }
+        std::vector<uint64_t> picked;
+        while (static_cast<int>(picked.size()) < children) {
+            // Favour nearby bags so chains get deep, and make sure gold gets parents
+            uint64_t child = (i < gold && p.chance(0.1)) ? gold : i + 1 + std::min<uint64_t>(remaining - 1, p.uniform(0, 20));
+            if (std::find(picked.begin(), picked.end(), child) == picked.end()) {picked.push_back(child);}
+        }
+        for (std::size_t j = 0; j < picked.size(); ++j) {
+            int count = p.uniform(1, i > gold ? 2 : 3);
+            out << count << ' ' << names[picked[j]] << (count == 1 ? " bag" : " bags") << (j + 1 == picked.size() ? ".\n" : ", ");
+        }
+    }
+}
+
+
+// N-instruction program, a single backwards jump makes it loop
+void generate_day8(std::ostream & out, Params & p) {
+    uint64_t n = std::max<uint64_t>(p.n, 4);
+    uint64_t loop_at = p.uniform(n / 2, n - 2);
+    for (uint64_t i = 0; i < n; ++i) {
+        if (i == loop_at) {
+            out << "jmp -" << p.uniform(1, loop_at) << '\n';
+            continue;
+        }
+        int64_t arg = p.uniform(-50, 50);
+        out << (p.chance(0.6) ? "acc " : "nop ") << (arg < 0 ? '-' : '+') << std::abs(arg) << '\n';
+    }
+}
+
+
+// N numbers with a 25 preamble, the first invalid number is the sum of a contiguous run
+void generate_day9(std::ostream & out, Params & p) {
+    const std::size_t window = 25;
+    uint64_t n = std::max<uint64_t>(p.n, 60);
+    std::vector<int64_t> nums = {0, 0};
+    while (nums.size() < window) {nums.push_back(p.uniform(1, 100));}
+    std::shuffle(nums.begin(), nums.end(), p.rng);
+
+    // Keeping two zeros in the window lets any window value repeat, so values stay bounded
+    uint64_t bad_at = p.uniform(n / 2, n - 1);
+    while (nums.size() < n) {
+        std::size_t start = nums.size() - window;
+        int zeros = std::count(nums.begin() + start, nums.end(), 0);
+        if (nums.size() == bad_at) {
+            // Contiguous run whose sum is too large to be a pair sum
+            int64_t max_val = *std::max_element(nums.begin() + start, nums.end());
+            std::size_t first = p.uniform(0, nums.size() - 2);
+            int64_t sum = nums[first] + nums[first + 1];
+            for (std::size_t i = first + 2; sum <= 2 * max_val && i < nums.size(); ++i) {sum += nums[i];}
+            if (sum > 2 * max_val) {
+                nums.push_back(sum);
+                continue;
+            }
+            ++bad_at;
+        }
+        if (nums[start] == 0 && zeros == 2) {
+            nums.push_back(0);
+            continue;
+        }
+        // Pairs must be two different entries of the window
+        std::size_t i = p.uniform(0, window - 1), j = (i + p.uniform(1, window - 1)) % window;
+        int64_t a = nums[start + i], b = nums[start + j];
+        nums.push_back((a + b < 1000000000) ? a + b : std::max(a, b));
+    }
+    for (const auto & num : nums) {out << num << '\n';}
+}
+
+
+// N adapters with 1 and 3 jolt gaps. A 3 jolt gap splits the part 2 count into a product over
+// the runs of 1 jolt gaps, so runs are at most 4 long (as in the real inputs) and a run is cut
+// short once it would take the count past 2^63. Large N then keeps adding runs of one gap.
+void generate_day10(std::ostream & out, Params & p) {
+    // Arrangements of a run of k 1 jolt gaps between two 3 jolt gaps
+    static const std::array<uint64_t, 5> RUN_WAYS = {1, 1, 2, 4, 7};
+    const uint64_t MAX_WAYS = 1ULL << 63;
+    std::vector<uint64_t> jolts;
+    uint64_t jolt = 0, ways = 1;
+    std::size_t run = 0;
+    for (uint64_t i = 0; i < std::max<uint64_t>(p.n, 2); ++i) {
+        uint64_t gap = (i == 0) ? 1 : (i == 1) ? 3 : p.chance(0.7) ? 1 : 3;
+        if (gap == 1 && (run + 1 == RUN_WAYS.size() || ways > MAX_WAYS / RUN_WAYS[run + 1])) {gap = 3;}
+        if (gap == 1) {
+            ++run;
+        } else {
+            ways *= RUN_WAYS[run];
+            run = 0;
+        }
+        jolt += gap;
+        jolts.push_back(jolt);
+    }
+    std::shuffle(jolts.begin(), jolts.end(), p.rng);
+    for (const auto & j : jolts) {out << j << '\n';}
+}
+
+
+/**
+ * Run day 11's seating rules on a layout until it settles. Random layouts can hold groups
+ * of seats that flip forever, those are found as the seats changing in a cycle of two
+ * steps (or still changing after SEAT_STEP_CAP steps) and turned into floor.
+ * @param seats Layout of 'L' and '.' cells inside a one cell border
+ * @param sight_lines Count the first seat seen in each direction (part 2) instead of the adjacent ones (part 1)
+ * @return True if the layout settled, false if seats were turned into floor
+ */
+bool settle_seats(common::Grid<char> & seats, bool sight_lines) {
+    const int SEAT_STEP_CAP = 10000;
+    const std::vector<std::ptrdiff_t> neighbours = seats.neighbour_offsets();
+    int tolerance = sight_lines ? 5 : 4;
+
+    // States two steps ago, one step ago and now
+    common::Grid<char> before = seats, prev = seats, grid = seats;
+    for (int step = 0; ; ++step) {
+        bool has_changed = false;
+        for (int row = 0; row < prev.rows(); ++row) {
+            const char *from = prev.row(row);
+            char *to = grid.row(row);
+            for (int col = 0; col < prev.cols(); ++col) {
+                to[col] = from[col];
+                if (from[col] == '.') {continue;}
+                int occupied = 0;
+                for (const auto & offset : neighbours) {
+                    const char *seen = from + col + offset;
+                    while (sight_lines && *seen == '.') {seen += offset;}
+                    occupied += (*seen == '#') ? 1 : 0;
+                }
+                if ((from[col] == 'L' && occupied == 0) || (from[col] == '#' && occupied >= tolerance)) {
+                    to[col] = (from[col] == 'L') ? '#' : 'L';
+                    has_changed = true;
+                }
+            }
+        }
+        if (!has_changed) {return true;}
+
+        bool cycle = step > 0;
+        for (int row = 0; row < grid.rows() && cycle; ++row) {
+            cycle = std::equal(grid.row(row), grid.row(row) + grid.cols(), before.row(row));
+        }
+        if (cycle || step >= SEAT_STEP_CAP) {
+            for (int row = 0; row < grid.rows(); ++row) {
+                for (int col = 0; col < grid.cols(); ++col) {
+                    if (grid(row, col) != prev(row, col)) {seats(row, col) = '.';}
+                }
+            }
+            return false;
+        }
+        before.swap(prev);
+        prev.swap(grid);
+    }
+}
+
+
+// N x M (default N) seat grid, which settles under the rules of both parts
+void generate_day11(std::ostream & out, Params & p) {
+    uint64_t cols = p.m ? p.m : p.n;
+    common::Grid<char> seats({static_cast<int>(p.n), static_cast<int>(cols)}, 1, '+');
+    for (uint64_t i = 0; i < p.n; ++i) {
+        for (uint64_t j = 0; j < cols; ++j) {seats(i, j) = p.chance(0.2) ? '.' : 'L';}
+    }
+
+    // Removing seats can unsettle the other part's rules, so check both again until neither changes the layout
+    while (!settle_seats(seats, false) || !settle_seats(seats, true)) {}
+    for (int row = 0; row < seats.rows(); ++row) {
+        out << std::string_view(seats.row(row), cols) << '\n';
+    }
+}
+
+
+// N navigation instructions, the waypoint is steered back when it drifts so coordinates stay bounded
+void generate_day12(std::ostream & out, Params & p) {
+    static const char dirs[] = "NESW";
+    int64_t wx = 10, wy = 1;
+    for (uint64_t i = 0; i < p.n; ++i) {
+        int kind = p.uniform(0, 9);
+        if (kind < 2) {
+            char turn = p.chance(0.5) ? 'L' : 'R';
+            int angle = 90 * p.uniform(1, 3);
+            for (int a = 0; a < angle; a += 90) {
+                std::swap(wx, wy);
+                if (turn == 'R') {wy = -wy;} else {wx = -wx;}
+            }
+            out << turn << angle << '\n';
+        } else if (kind < 5) {
+            out << 'F' << p.uniform(1, 100) << '\n';
+        } else {
+            int dir = p.uniform(0, 3);
+            if (std::abs(wy) > 100) {dir = wy > 0 ? 2 : 0;}
+            if (std::abs(wx) > 100) {dir = wx > 0 ? 3 : 1;}
+            int dist = p.uniform(1, 20);
+            if (dir % 2 == 0) {
+                wy += (dir == 0) ? dist : -dist;
+            } else {
+                wx += (dir == 1) ? dist : -dist;
+            }
+            out << dirs[dir] << dist << '\n';
+        }
+    }
+}
+
+
+// Schedule of N slots, buses are distinct primes whose product fits in 64 bits
+void generate_day13(std::ostream & out, Params & p) {
+    static const std::vector<uint64_t> primes = {13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97};
+    uint64_t slots = std::max<uint64_t>(p.n, 2);
+    std::vector<uint64_t> buses = primes;
+    std::shuffle(buses.begin(), buses.end(), p.rng);
+    uint64_t product = 1;
+    std::size_t num_buses = 0;
+    while (num_buses < buses.size() && num_buses < slots && product < (1ULL << 56) / buses[num_buses]) {
+        product *= buses[num_buses++];
+    }
+
+    // First slot must be a bus, the rest are spread over the schedule
+    std::vector<uint64_t> schedule(slots, 0);
+    std::vector<uint64_t> positions(slots - 1);
+    std::iota(positions.begin(), positions.end(), 1);
+    std::shuffle(positions.begin(), positions.end(), p.rng);
+    schedule[0] = buses[0];
+    for (std::size_t i = 1; i < num_buses; ++i) {schedule[positions[i - 1]] = buses[i];}
+
+    out << p.uniform(1000000, 1010000) << '\n';
+    for (uint64_t i = 0; i < slots; ++i) {
+        if (schedule[i]) {out << schedule[i];} else {out << 'x';}
+        out << (i + 1 == slots ? '\n' : ',');
+    }
+}
+
+
+// N program lines, masks with at most 6 floating bits
+void generate_day14(std::ostream & out, Params & p) {
+    for (uint64_t i = 0; i < p.n; ++i) {
+        if (i % 5 == 0) {
+            std::string mask(36, '0');
+            for (auto & c : mask) {c = p.chance(0.5) ? '1' : '0';}
+            for (int x = p.uniform(0, 6); x > 0; --x) {mask[p.uniform(0, 35)] = 'X';}
+            out << "mask = " << mask << '\n';
+        } else {
+            out << "mem[" << p.uniform(1, 65535) << "] = " << p.uniform(1, 1ULL << 30) << '\n';
+        }
+    }
+}
+
+
+// N distinct starting numbers
+void generate_day15(std::ostream & out, Params & p) {
+    uint64_t n = std::max<uint64_t>(p.n, 1);
+    std::vector<uint64_t> nums(std::max<uint64_t>(n, 20) * 2);
+    std::iota(nums.begin(), nums.end(), 0);
+    std::shuffle(nums.begin(), nums.end(), p.rng);
+    for (uint64_t i = 0; i < n; ++i) {
+        out << nums[i] << (i + 1 == n ? '\n' : ',');
+    }
+}
+
+
+// N fields and M (default 4N) nearby tickets, each field eliminates exactly one more column
+void generate_day16(std::ostream & out, Params & p) {
+    uint64_t fields = std::max<uint64_t>(p.n, 6);
+    uint64_t tickets = p.m ? p.m : 4 * fields;
+    int64_t max_val = 100 * fields + 99;
+    std::vector<uint64_t> column(fields);
+    std::iota(column.begin(), column.end(), 0);
+    std::shuffle(column.begin(), column.end(), p.rng);
+
+    // Field k accepts values >= 100k, column of field k only holds values in [100k, 100k + 99].
+    // The departure fields are the first six, so their values are below 600 and the part 2 product fits in 64 bits
+    for (uint64_t k = 0; k < fields; ++k) {
+        std::string name = (k < 6) ? "departure " + index_word(k) : "field " + index_word(k);
+        out << name << ": " << 100 * k << '-' << 100 * k + 50 << " or " << 100 * k + 51 << '-' << max_val << '\n';
+    }
+    auto ticket = [&](bool valid) {
+        std::vector<int64_t> nums(fields);
+        // Non-zero, so the part 2 product isn't 0
+        for (uint64_t k = 0; k < fields; ++k) {nums[column[k]] = p.uniform(100 * k + 1, 100 * k + 99);}
+        if (!valid) {nums[p.uniform(0, fields - 1)] = p.uniform(max_val + 1, 2 * max_val);}
+        for (uint64_t j = 0; j < fields; ++j) {out << nums[j] << (j + 1 == fields ? '\n' : ',');}
+    };
+
+    out << "\nyour ticket:\n";
+    ticket(true);
+    out << "\nnearby tickets:\n";
+    for (uint64_t i = 0; i < tickets; ++i) {ticket(!p.chance(0.2));}
+}
+
+
+// N x N initial slice
+void generate_day17(std::ostream & out, Params & p) {
+    uint64_t cols = p.m ? p.m : p.n;
+    std::string row(cols, '.');
+    for (uint64_t i = 0; i < p.n; ++i) {
+        for (auto & c : row) {c = p.chance(0.4) ? '#' : '.';}
+        out << row << '\n';
+    }
+}
+
+
+/**
+ * Random expression with at most two levels of brackets
+ * @param p Generator parameters
+ * @param depth Current bracket depth
+ * @return The expression string
+ */
+std::string random_expression(Params & p, int depth) {
+    std::string expr;
+    int operands = p.uniform(2, depth == 0 ? 5 : 3);
+    for (int i = 0; i < operands; ++i) {
+        if (i > 0) {expr += p.chance(0.5) ? " + " : " * ";}
+        if (depth < 2 && p.chance(0.25)) {
+            expr += "(" + random_expression(p, depth + 1) + ")";
+        } else {
+            expr += std::to_string(p.uniform(1, 9));
+        }
+    }
+    return expr;
+}
+
+
+// N expressions
+void generate_day18(std::ostream & out, Params & p) {
+    for (uint64_t i = 0; i < p.n; ++i) {
+        out << random_expression(p, 0) << '\n';
+    }
+}
+
+
+/**
+ * Expand a rule into a random message it matches
+ * @param rules Rule alternatives, each a sequence of rule ids, or a literal
+ * @param literals Literal char for leaf rules, 0 otherwise
+ * @param id Rule to expand
+ * @param p Generator parameters
+ * @param message Message to append to
+ */
+void expand_rule(const std::vector<std::vector<std::vector<int>>> & rules, const std::vector<char> & literals,
+                 int id, Params & p, std::string & message) {
+    if (literals[id]) {
+        message.push_back(literals[id]);
+        return;
+    }
+    const auto & alt = rules[id][p.uniform(0, rules[id].size() - 1)];
+    for (const auto & child : alt) {expand_rule(rules, literals, child, p, message);}
+}
+
+
+// N rules (at least 50) and M (default N) messages, 42 and 31 match 8 character strings
+void generate_day19(std::ostream & out, Params & p) {
+    int n = std::max<uint64_t>(p.n, 50);
+    uint64_t messages = p.m ? p.m : p.n;
+    std::vector<std::vector<std::vector<int>>> rules(n);
+    std::vector<char> literals(n, 0);
+
+    // Assign rule ids to levels, rule 42 and 31 are level 3 (8 chars)
+    std::vector<int> ids;
+    for (int id = 0; id < n; ++id) {
+        if (id != 0 && id != 8 && id != 11 && id != 42 && id != 31) {ids.push_back(id);}
+    }
+    std::shuffle(ids.begin(), ids.end(), p.rng);
+    std::array<std::vector<int>, 4> levels;
+    levels[0] = {ids[0], ids[1]};
+    literals[ids[0]] = 'a';
+    literals[ids[1]] = 'b';
+    levels[3] = {42, 31};
+    for (std::size_t i = 2; i < ids.size(); ++i) {
+        levels[1 + (i < 6 ? i % 3 : p.uniform(0, 2))].push_back(ids[i]);
+    }
+
+    // Each rule is one or two sequences of two rules from the level below
+    for (int level = 1; level <= 3; ++level) {
+        const auto & below = levels[level - 1];
+        for (const auto & id : levels[level]) {
+            int alternatives = p.uniform(1, 2);
+            for (int a = 0; a < alternatives; ++a) {
+                rules[id].push_back({below[p.uniform(0, below.size() - 1)], below[p.uniform(0, below.size() - 1)]});
+            }
+        }
+    }
+    rules[8] = {{42}};
+    rules[11] = {{42, 31}};
+    rules[0] = {{8, 11}};
+
+    for (int id = 0; id < n; ++id) {
+        out << id << ": ";
+        if (literals[id]) {
+            out << '"' << literals[id] << "\"\n";
+            continue;
+        }
+        for (std::size_t a = 0; a < rules[id].size(); ++a) {
+            if (a > 0) {out << " | ";}
+            for (std::size_t c = 0; c < rules[id][a].size(); ++c) {
+                out << (c > 0 ? " " : "") << rules[id][a][c];
+            }
+        }
+        out << '\n';
+    }
+
+    // Part 1 matches, part 2 only matches (42^k 31^j with k > j) and noise
+    out << '\n';
+    for (uint64_t i = 0; i < messages; ++i) {
+        std::string message;
+        int kind = p.uniform(0, 2);
+        if (kind == 0) {
+            expand_rule(rules, literals, 0, p, message);
+        } else if (kind == 1) {
+            int j = p.uniform(1, 4), k = j + p.uniform(1, 3);
+            for (int r = 0; r < k; ++r) {expand_rule(rules, literals, 42, p, message);}
+            for (int r = 0; r < j; ++r) {expand_rule(rules, literals, 31, p, message);}
+        } else {
+            for (int c = 0, len = 8 * p.uniform(3, 6); c < len; ++c) {message.push_back(p.chance(0.5) ? 'a' : 'b');}
+        }
+        out << message << '\n';
+    }
+}
+
+
+const std::vector<Generator> GENERATORS = {
+    generate_day1, generate_day2, generate_day3, generate_day4, generate_day5,
+    generate_day6, generate_day7, generate_day8, generate_day9, generate_day10,
+    generate_day11, generate_day12, generate_day13, generate_day14, generate_day15,
+    generate_day16, generate_day17, generate_day18, generate_day19,
+};
+
+
+void print_usage(const char *name) {
+    std::cout << "Usage: " << name << " DAY N [options] > dayN.txt" << std::endl
+              << "  DAY             Day to generate an input for" << std::endl
+              << "  N               Input size: lines, records, nodes, rows or rules depending on the day" << std::endl
+              << "  -m, --cols M    Secondary size: grid columns (days 3, 11, 17), tickets (16), messages (19)" << std::endl
+              << "  -s, --seed S    Random seed (default: 1)" << std::endl
+              << "  -h, --help      Show this message" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+    std::vector<std::string> positional;
+    uint64_t cols = 0, seed = 1;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            } else if ((arg == "-m" || arg == "--cols") && i + 1 < argc) {
+                cols = common::to_number<uint64_t>(argv[++i]);
+            } else if ((arg == "-s" || arg == "--seed") && i + 1 < argc) {
+                seed = common::to_number<uint64_t>(argv[++i]);
+            } else {
+                positional.push_back(arg);
+            }
+        }
+        if (positional.size() != 2) {throw std::invalid_argument("Expected DAY and N");}
+
+        int day = common::to_number<int>(positional[0]);
+        uint64_t n = common::to_number<uint64_t>(positional[1]);
+        if (day < 1 || day > static_cast<int>(GENERATORS.size()) || n == 0) {throw std::invalid_argument("Invalid DAY or N");}
+
+        std::ios_base::sync_with_stdio(false);
+        Params params{n, cols, std::mt19937_64(seed)};
+        GENERATORS[day - 1](std::cout, params);
+    } catch (const std::exception &) {
+        print_usage(argv[0]);
+        return 1;
+    }
+}
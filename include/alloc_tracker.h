@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+ * Heap allocation accounting per solver phase.
+ *
+ * Opt-in at build time (cmake -DAOC_ALLOC_TRACKING=ON). The executable's main file defines
+ * AOC_ALLOC_HOOKS before including this header to install the global operator new/delete
+ * replacements. Counters are per thread, so a phase only sees its own thread's allocations.
+ * Memory freed on a different thread than it was allocated on skews that thread's live bytes.
+ *
+ *   alloc::Phase phase;
+ *   solver->part1();
+ *   alloc::Stats stats = phase.stop();
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace alloc {
+
+// Allocations made during a phase
+struct Stats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    uint64_t peak_bytes = 0;      // Peak live bytes above the live bytes at the start of the phase
+};
+
+// Raw per-thread counters, updated by the hooks
+struct ThreadCounters {
+    uint64_t count;
+    uint64_t bytes;
+    int64_t live;
+    int64_t peak;
+};
+
+/**
+ * @return True if the build has the allocation hooks compiled in
+ */
+constexpr bool enabled() {
+#ifdef AOC_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline ThreadCounters & thread_counters() {
+    // Zero initialized, so safe to touch from inside operator new
+    static thread_local ThreadCounters counters;
+    return counters;
+}
+
+inline void record_alloc(std::size_t requested, std::size_t usable) {
+    ThreadCounters & c = thread_counters();
+    ++c.count;
+    c.bytes += requested;
+    c.live += usable;
+    if (c.live > c.peak) {c.peak = c.live;}
+}
+
+inline void record_free(std::size_t usable) {
+    thread_counters().live -= usable;
+}
+
+
+/**
+ * Measures the allocations of the calling thread between construction (or start()) and stop().
+ * Phases on the same thread must not nest, each one resets the peak.
+ */
+class Phase {
+public:
+    Phase() {
+        start();
+    }
+
+    void start() {
+        ThreadCounters & c = thread_counters();
+        start_count = c.count;
+        start_bytes = c.bytes;
+        start_live = c.live;
+        c.peak = c.live;
+    }
+
+    Stats stop() const {
+        const ThreadCounters & c = thread_counters();
+        Stats stats;
+        stats.count = c.count - start_count;
+        stats.bytes = c.bytes - start_bytes;
+        stats.peak_bytes = (c.peak > start_live) ? c.peak - start_live : 0;
+        return stats;
+    }
+
+private:
+    uint64_t start_count, start_bytes;
+    int64_t start_live;
+};
+
+
+// Upper bounds for one day's phase, read from a budget file
+struct Budget {
+    int day;
+    std::string phase;
+    uint64_t max_count;
+    uint64_t max_peak_bytes;
+};
+
+/**
+ * Read allocation budgets, one "day phase max_allocs max_peak_bytes" entry per line,
+ * blank lines and lines starting with # are ignored
+ * @param path The budget file
+ * @return The budgets
+ */
+inline std::vector<Budget> read_budgets(const std::string & path) {
+    std::ifstream in(path);
+    if (!in) {throw std::runtime_error("Cannot open " + path);}
+
+    std::vector<Budget> budgets;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {continue;}
+        std::istringstream iss(line);
+        Budget budget;
+        if (!(iss >> budget.day >> budget.phase >> budget.max_count >> budget.max_peak_bytes)) {
+            throw std::runtime_error("Invalid budget line: " + line);
+        }
+        budgets.push_back(budget);
+    }
+    return budgets;
+}
+
+} // namespace alloc
+
+
+#if defined(AOC_ALLOC_TRACKING) && defined(AOC_ALLOC_HOOKS)
+
+#include <new>
+#include <cstdlib>
+#include <malloc.h>     // malloc_usable_size
+
+namespace alloc {
+
+inline void *tracked_alloc(std::size_t size, std::size_t align) {
+    if (size == 0) {size = 1;}
+    void *ptr = (align > alignof(std::max_align_t))
+        ? std::aligned_alloc(align, (size + align - 1) / align * align)
+        : std::malloc(size);
+    if (ptr) {record_alloc(size, malloc_usable_size(ptr));}
+    return ptr;
+}
+
+inline void tracked_free(void *ptr) {
+    if (!ptr) {return;}
+    record_free(malloc_usable_size(ptr));
+    std::free(ptr);
+}
+
+} // namespace alloc
+
+void *operator new(std::size_t size) {
+    if (void *ptr = alloc::tracked_alloc(size, 0)) {return ptr;}
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    if (void *ptr = alloc::tracked_alloc(size, 0)) {return ptr;}
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    if (void *ptr = alloc::tracked_alloc(size, static_cast<std::size_t>(align))) {return ptr;}
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+    if (void *ptr = alloc::tracked_alloc(size, static_cast<std::size_t>(align))) {return ptr;}
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return alloc::tracked_alloc(size, 0);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return alloc::tracked_alloc(size, 0);
+}
+
+void operator delete(void *ptr) noexcept {alloc::tracked_free(ptr);}
+void operator delete[](void *ptr) noexcept {alloc::tracked_free(ptr);}
+void operator delete(void *ptr, std::size_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete[](void *ptr, std::size_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete(void *ptr, std::align_val_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete[](void *ptr, std::align_val_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {alloc::tracked_free(ptr);}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {alloc::tracked_free(ptr);}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {alloc::tracked_free(ptr);}
+
+#endif
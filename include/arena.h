@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * Scratch memory for the temporaries a hot loop builds per line or record.
+ *
+ * An Arena is a monotonic buffer behind a std::pmr::memory_resource. Allocations bump a
+ * pointer into a buffer owned by the arena, and reset() frees them all at once, so after
+ * the first record the loop allocates nothing from the heap. Only a record needing more
+ * than the buffer falls back to the default allocator.
+ *
+ *   static thread_local common::Arena arena;
+ *   for (const auto & line : lines) {
+ *       arena.reset();
+ *       std::pmr::vector<std::string_view> tokens(arena.resource());
+ *       ...
+ *   }
+ *
+ * Anything allocated from the arena must be dead before the next reset().
+ */
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+
+namespace common {
+
+class Arena {
+public:
+    static const std::size_t DEFAULT_SIZE = 4 << 10;
+
+    /**
+     * @param size Size of the arena's own buffer, allocated once
+     */
+    explicit Arena(std::size_t size = DEFAULT_SIZE)
+        : buffer(new std::byte[size]), pool(buffer.get(), size) {}
+
+    Arena(const Arena &) = delete;
+    Arena & operator=(const Arena &) = delete;
+
+    std::pmr::memory_resource * resource() {
+        return &pool;
+    }
+
+    /**
+     * Free everything allocated since the last reset, later allocations reuse the buffer
+     */
+    void reset() {
+        pool.release();
+    }
+
+private:
+    std::unique_ptr<std::byte[]> buffer;
+    std::pmr::monotonic_buffer_resource pool;
+};
+
+} // namespace common
@@ -1,46 +1,187 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <iterator>
-#include <regex>
-#include <algorithm>    // find_if, erase
+#include <string_view>
+#include <optional>
+#include <span>
+#include <utility>      // swap
+#include <stdexcept>    // runtime_error
+#include <cstring>      // memchr, strerror
+#include <cerrno>
+#include <charconv>     // from_chars
+#include <type_traits>
+#include <algorithm>    // find_if, erase, min
 #include <stdlib.h>     // exit
+#include <fcntl.h>      // open
+#include <unistd.h>     // read, close
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
 
 
 namespace common {
 
 /**
- * Read in a single 
+ * Read-only view over the whole puzzle input.
+ * Regular files are memory mapped, anything else (pipes, terminals) is read in
+ * one bulk pass into an owned buffer. Either way the data is never copied again,
+ * so the string_views handed out stay valid for as long as the Input lives.
  */
-template <typename T>
-std::vector<T> read_stdin(const char delimiter = ' ') {
-    std::vector<T> inputs;
-    T input;
+class Input {
+public:
+    Input() = default;
 
-    while (std::cin >> input) {
-        inputs.push_back(input);
-        if (std::cin.peek() == delimiter) {
-            std::cin.ignore();
+    /**
+     * Map (or bulk read) the given file descriptor, the descriptor is not closed
+     * @param fd The file descriptor to read
+     */
+    explicit Input(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                mapping = static_cast<char *>(addr);
+                mapped_size = st.st_size;
+                return;
+            }
         }
+        read_all(fd);
     }
 
-    if (!std::cin.eof()) {
-        std::cerr << "Error proccessing input." << std::endl;
-        exit(1);
+    /**
+     * Take ownership of an in-memory buffer
+     * @param data The input data
+     */
+    explicit Input(std::string data) : owned(std::move(data)) {}
+
+    Input(Input && other) noexcept { swap(other); }
+    Input & operator=(Input && other) noexcept {
+        swap(other);
+        return *this;
     }
+    Input(const Input &) = delete;
+    Input & operator=(const Input &) = delete;
 
-    return inputs;
+    ~Input() {
+        if (mapping != nullptr) {
+            munmap(mapping, mapped_size);
+        }
+    }
+
+    /**
+     * Read the entire stdin
+     */
+    static Input from_stdin() {
+        return Input(STDIN_FILENO);
+    }
+
+    /**
+     * Read the entire file
+     * @param path Path of the file to read
+     * @throws std::runtime_error if the file can't be opened
+     */
+    static Input from_file(const std::string & path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+        }
+        Input input(fd);
+        close(fd);
+        return input;
+    }
+
+    const char * data() const {
+        return mapping != nullptr ? mapping : owned.data();
+    }
+
+    std::size_t size() const {
+        return mapping != nullptr ? mapped_size : owned.size();
+    }
+
+    std::string_view view() const {
+        return {data(), size()};
+    }
+
+    /**
+     * Split the input into lines, views point into this buffer
+     * @return Vector of views, each element represents an input line
+     */
+    std::vector<std::string_view> lines() const;
+
+private:
+    char *mapping = nullptr;
+    std::size_t mapped_size = 0;
+    std::string owned;
+
+    void swap(Input & other) noexcept {
+        std::swap(mapping, other.mapping);
+        std::swap(mapped_size, other.mapped_size);
+        std::swap(owned, other.owned);
+    }
+
+    // Fallback for non-seekable inputs, grow the buffer geometrically
+    void read_all(int fd) {
+        std::size_t len = 0;
+        owned.resize(1 << 16);
+        while (true) {
+            if (len == owned.size()) {
+                owned.resize(owned.size() * 2);
+            }
+            ssize_t n = read(fd, &owned[len], owned.size() - len);
+            if (n == 0) {
+                break;
+            }
+            if (n < 0) {
+                if (errno == EINTR) {continue;}
+                std::cerr << "Error proccessing input." << std::endl;
+                exit(1);
+            }
+            len += n;
+        }
+        owned.resize(len);
+    }
+};
+
+
+/**
+ * Split a buffer into lines, with the same semantics as repeated std::getline
+ * (no trailing empty line if the buffer ends with a newline)
+ * @param s The buffer to split
+ * @return Vector of views into the buffer, each element represents a line
+ */
+inline std::vector<std::string_view> split_lines(std::string_view s) {
+    std::vector<std::string_view> lines;
+    const char *it = s.data(), *end = s.data() + s.size();
+    while (it < end) {
+        const char *nl = static_cast<const char *>(std::memchr(it, '\n', end - it));
+        if (nl == nullptr) {
+            lines.emplace_back(it, end - it);
+            break;
+        }
+        lines.emplace_back(it, nl - it);
+        it = nl + 1;
+    }
+
+    return lines;
+}
+
+inline std::vector<std::string_view> Input::lines() const {
+    return split_lines(view());
 }
 
+
 /**
  * Read in lines from stdin
  * @returns Vector of strings, each element represents an input line
  */
-std::vector<std::string> read_stdin_lines() {
+inline std::vector<std::string> read_stdin_lines() {
+    Input input = Input::from_stdin();
     std::vector<std::string> inputs;
-    for (std::string line; std::getline(std::cin, line);) {
-        inputs.push_back(line);
+    for (const auto & line : input.lines()) {
+        inputs.emplace_back(line);
     }
 
     return inputs;
@@ -48,30 +189,218 @@ std::vector<std::string> read_stdin_lines() {
 
 
 /**
- * Split a string by a given delimiter
+ * Convert a string to a number, without the allocation and locale overhead of std::stoi.
+ * A leading '+' is accepted, anything else not part of the number is an error.
  * @param s The input string
- * @param delim The delimiter to split by
- * @return Vector of string split by delim
+ * @return The parsed number
+ * @throws std::invalid_argument or std::out_of_range, same as std::stoi
+ */
+template <typename T>
+T to_number(std::string_view s) {
+    static_assert(std::is_integral_v<T>, "to_number requires an integral type");
+    if (!s.empty() && s[0] == '+') {
+        s.remove_prefix(1);
+    }
+    T value{};
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec == std::errc::result_out_of_range) {
+        throw std::out_of_range("Number out of range: " + std::string(s));
+    }
+    if (ec != std::errc() || ptr != s.data() + s.size()) {
+        throw std::invalid_argument("Not a number: " + std::string(s));
+    }
+    return value;
+}
+
+
+/**
+ * Parse a list of numbers separated by a delimiter and/or whitespace
+ * @param s The buffer to parse
+ * @param delimiter Additional character separating the numbers
+ * @return Vector of parsed numbers
+ * @throws std::invalid_argument or std::out_of_range on malformed input
  */
-std::vector<std::string> split(const std::string & s, char delim = ' ') {
-    std::vector<std::string> elems;
-    auto result = std::back_inserter(elems);
-    std::istringstream iss(s[0] == delim ? s.substr(1) : s);
-    std::string item;
-    while (std::getline(iss, item, delim)) {
-        *result++ = item;
+template <typename T>
+std::vector<T> read_numbers(std::string_view s, const char delimiter = ' ') {
+    static_assert(std::is_integral_v<T>, "read_numbers requires an integral type");
+    auto is_separator = [delimiter](char c) {
+        return c == delimiter || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    };
+
+    // One cheap counting pass avoids repeated reallocation on large lists
+    std::vector<T> numbers;
+    numbers.reserve(std::count(s.begin(), s.end(), delimiter) + (delimiter != '\n' ? std::count(s.begin(), s.end(), '\n') : 0) + 1);
+
+    const char *it = s.data(), *end = s.data() + s.size();
+    while (true) {
+        while (it < end && is_separator(*it)) {++it;}
+        if (it == end) {break;}
+        if (*it == '+') {++it;}
+
+        T value{};
+        auto [ptr, ec] = std::from_chars(it, end, value);
+        if (ec == std::errc::result_out_of_range) {
+            throw std::out_of_range("Number out of range at offset " + std::to_string(it - s.data()));
+        }
+        if (ec != std::errc() || (ptr < end && !is_separator(*ptr))) {
+            throw std::invalid_argument("Not a number at offset " + std::to_string(it - s.data()));
+        }
+        numbers.push_back(value);
+        it = ptr;
     }
 
-    return elems;
+    return numbers;
 }
 
 
+/**
+ * Read in a list of values from stdin, separated by whitespace and/or the delimiter.
+ * Integral types go through the from_chars parser, everything else through iostream.
+ */
+template <typename T>
+std::vector<T> read_stdin(const char delimiter = ' ') {
+    if constexpr (std::is_integral_v<T>) {
+        Input input = Input::from_stdin();
+        try {
+            return read_numbers<T>(input.view(), delimiter);
+        } catch (const std::exception &) {
+            std::cerr << "Error proccessing input." << std::endl;
+            exit(1);
+        }
+    } else {
+        std::vector<T> inputs;
+        T input;
+
+        while (std::cin >> input) {
+            inputs.push_back(input);
+            if (std::cin.peek() == delimiter) {
+                std::cin.ignore();
+            }
+        }
+
+        if (!std::cin.eof()) {
+            std::cerr << "Error proccessing input." << std::endl;
+            exit(1);
+        }
+
+        return inputs;
+    }
+}
+
+
+/**
+ * Splits a string into fields separated by any of a set of delimiter characters.
+ * Fields are views into the string, found lazily as the tokenizer is iterated, so
+ * splitting never allocates.
+ *
+ *   for (std::string_view token : common::Tokenizer(line, " -:")) {...}
+ *
+ *   std::array<std::string_view, 4> tokens;
+ *   if (common::Tokenizer(line, " -:").fill(tokens) != tokens.size()) {...}
+ */
+class Tokenizer {
+public:
+    /**
+     * @param s The string to split, must outlive the tokenizer and its fields
+     * @param delims The delimiter characters, one or several
+     * @param keep_empty Yield the empty fields around adjacent delimiters, by default a run
+     *                   of delimiters separates two fields and leading/trailing ones are ignored
+     */
+    explicit Tokenizer(std::string_view s, std::string_view delims = " ", bool keep_empty = false)
+        : s(s), delims(delims), keep_empty(keep_empty) {}
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        iterator() = default;
+
+        reference operator*() const {return field;}
+        pointer operator->() const {return &field;}
+
+        iterator & operator++() {
+            next();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator prev = *this;
+            next();
+            return prev;
+        }
+
+        bool operator==(const iterator & other) const {return field.data() == other.field.data() && done == other.done;}
+        bool operator!=(const iterator & other) const {return !(*this == other);}
+
+    private:
+        friend class Tokenizer;
+        const Tokenizer *tokenizer = nullptr;
+        std::string_view field;
+        std::size_t pos = 0;            // Where the search for the next field starts
+        bool done = true;
+
+        explicit iterator(const Tokenizer *tokenizer) : tokenizer(tokenizer), done(false) {
+            next();
+        }
+
+        void next() {
+            const std::string_view & s = tokenizer->s;
+            std::size_t begin = tokenizer->keep_empty ? pos : s.find_first_not_of(tokenizer->delims, pos);
+            if (begin == std::string_view::npos || begin > s.size()) {
+                field = {};
+                done = true;
+                return;
+            }
+            std::size_t end = std::min(tokenizer->find_delim(begin), s.size());
+            field = s.substr(begin, end - begin);
+            pos = end + 1;
+        }
+    };
+
+    iterator begin() const {
+        return s.empty() ? end() : iterator(this);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+
+    /**
+     * Split into a caller provided buffer
+     * @param out Buffer for the fields
+     * @return Number of fields in the string, fields past the end of the buffer are counted but not stored
+     */
+    std::size_t fill(std::span<std::string_view> out) const {
+        std::size_t count = 0;
+        for (std::string_view field : *this) {
+            if (count < out.size()) {out[count] = field;}
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    std::string_view s, delims;
+    bool keep_empty;
+
+    // A single delimiter is found with memchr
+    std::size_t find_delim(std::size_t from) const {
+        if (delims.size() != 1) {return s.find_first_of(delims, from);}
+        const void *found = std::memchr(s.data() + from, delims[0], s.size() - from);
+        return found == nullptr ? std::string_view::npos : static_cast<const char *>(found) - s.data();
+    }
+};
+
+
 /**
  * Checks if a given string is a (positive) integer
  * @param s The input string
  * @return True if the input string is a (positive) integer
  */
-bool is_number(const std::string & s) {
+inline bool is_number(std::string_view s) {
     auto is_digit = [](unsigned char c) { return !std::isdigit(c); };
     return (!s.empty() && std::find_if(s.begin(), s.end(), is_digit) == s.end());
 }
@@ -82,19 +411,55 @@ bool is_number(const std::string & s) {
  * @param s The string to consider
  * @param c The char to erase from the input string
  */
-void erase(std::string & s, char c) {
+inline void erase(std::string & s, char c) {
     s.erase(std::remove(s.begin(), s.end(), c), s.end());
 }
 
 /**
- * Replace all occurance in a string
+ * Replace all occurances of a literal substring, in one pass over the string
  * @param s The input string
  * @param from The string to look to replace
  * @param to The string fill the replacement
  * @return The replaced string
  */
-std::string replace(const std::string & s, const std::string & from, const std::string & to) {
-    return std::regex_replace(s, std::regex(from), to);
+inline std::string replace(std::string_view s, std::string_view from, std::string_view to) {
+    if (from.empty()) {return std::string(s);}
+    std::string result;
+    result.reserve(s.size());
+    std::size_t begin = 0, found;
+    while ((found = s.find(from, begin)) != std::string_view::npos) {
+        result.append(s.substr(begin, found - begin));
+        result.append(to);
+        begin = found + from.size();
+    }
+    result.append(s.substr(begin));
+    return result;
+}
+
+/**
+ * Replace many tokens at once, in one pass over the string.
+ * Delimiters are copied through, so only whole tokens are ever replaced.
+ * @param s The input string
+ * @param delims Characters separating the tokens
+ * @param lookup Called with each token, returns its replacement or std::nullopt to keep it
+ * @return The replaced string
+ */
+template <typename Lookup>
+std::string replace_tokens(std::string_view s, std::string_view delims, Lookup && lookup) {
+    std::string result;
+    result.reserve(s.size());
+    std::size_t begin = 0;
+    while (begin < s.size()) {
+        std::size_t token_begin = std::min(s.find_first_not_of(delims, begin), s.size());
+        result.append(s.substr(begin, token_begin - begin));
+        if (token_begin == s.size()) {break;}
+        std::size_t token_end = std::min(s.find_first_of(delims, token_begin), s.size());
+        std::string_view token = s.substr(token_begin, token_end - token_begin);
+        std::optional<std::string_view> replacement = lookup(token);
+        result.append(replacement ? *replacement : token);
+        begin = token_end;
+    }
+    return result;
 }
 
 } // namespace common
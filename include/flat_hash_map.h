@@ -0,0 +1,476 @@
+#pragma once
+
+/**
+ * Open addressing hash map and set, for the hot loops keyed by integers.
+ *
+ * Elements live in one flat array, next to an array with a control byte per slot:
+ * EMPTY, DELETED, or 7 bits of the element's hash. A lookup loads the control bytes of
+ * 16 slots at a time and compares them all at once (SSE2 where available), so it only
+ * compares the keys whose hash bits match, and stops at the first group with an empty
+ * slot. Groups are probed linearly. Inserting only allocates when the table grows, and
+ * clear() keeps the slots, so a table reused across runs stops allocating.
+ *
+ *   common::FlatHashMap<int, int> last_seen;
+ *   last_seen.reserve(1 << 20);
+ *   last_seen[number] = round;
+ *
+ * The interface is a subset of std::unordered_map/set. Unlike them, an insert can move
+ * every element (invalidating iterators and references), and keys should be cheap to
+ * hash and compare, as a rehash hashes every key again.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>              // memset, memcpy
+#include <memory>               // allocator, construct_at, destroy_at
+#include <utility>              // pair, move, swap, exchange
+#include <tuple>                // forward_as_tuple
+#include <functional>           // hash, equal_to
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>            // out_of_range
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace common {
+
+namespace flat_hash {
+
+// Control byte of a free slot, a full slot holds 7 bits of its hash (0 to 127)
+const int8_t EMPTY = -128;
+const int8_t DELETED = -2;
+const std::size_t GROUP_WIDTH = 16;
+
+
+/**
+ * The control bytes of GROUP_WIDTH consecutive slots, matched all at once
+ */
+class Group {
+public:
+    explicit Group(const int8_t *ctrl) {
+#ifdef __SSE2__
+        bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+        std::memcpy(bytes, ctrl, GROUP_WIDTH);
+#endif
+    }
+
+    /**
+     * @param value The control byte to look for
+     * @return Bitmask of the slots holding the control byte
+     */
+    uint32_t match(int8_t value) const {
+#ifdef __SSE2__
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)));
+#else
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+            mask |= static_cast<uint32_t>(bytes[i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * @return Bitmask of the empty or deleted slots, the control bytes with their sign bit set
+     */
+    uint32_t match_free() const {
+#ifdef __SSE2__
+        return _mm_movemask_epi8(bytes);
+#else
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+            mask |= static_cast<uint32_t>(bytes[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+private:
+#ifdef __SSE2__
+    __m128i bytes;
+#else
+    int8_t bytes[GROUP_WIDTH];
+#endif
+};
+
+
+/**
+ * Spread the bits of a hash, std::hash of an integer is usually the integer itself
+ */
+inline uint64_t mix(uint64_t h) {
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+}
+
+
+/**
+ * Table shared by FlatHashMap and FlatHashSet
+ * @tparam Key The key type
+ * @tparam Value The element type, the key itself for a set
+ * @tparam KeyOf Function object getting the key of an element
+ */
+template <typename Key, typename Value, typename KeyOf, typename Hash, typename KeyEqual>
+class Table {
+    // Keys of a set can't be changed in place
+    static constexpr bool IS_SET = std::is_same_v<Key, Value>;
+
+public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef std::size_t size_type;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const || IS_SET, const Value *, Value *>;
+        using reference = std::conditional_t<Const || IS_SET, const Value &, Value &>;
+
+        Iterator() = default;
+
+        // A const iterator from a mutable one, a template so it's never the copy constructor
+        template <bool OtherConst> requires (Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> & other)
+            : ctrl(other.ctrl), slot(other.slot), last(other.last) {}
+
+        reference operator*() const {return *slot;}
+        pointer operator->() const {return slot;}
+
+        Iterator & operator++() {
+            ++ctrl;
+            ++slot;
+            skip_free();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const Iterator & other) const {return slot == other.slot;}
+
+    private:
+        friend class Table;
+        friend class Iterator<!Const>;
+
+        const int8_t *ctrl = nullptr;
+        Value *slot = nullptr, *last = nullptr;
+
+        Iterator(const int8_t *ctrl, Value *slot, Value *last) : ctrl(ctrl), slot(slot), last(last) {}
+
+        void skip_free() {
+            while (slot != last && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+    };
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    Table() = default;
+
+    Table(const Table & other) {
+        reserve(other.size());
+        for (const auto & value : other) {
+            insert_new(hash_of(KeyOf()(value)), value);
+        }
+    }
+
+    Table(Table && other) noexcept
+        : ctrl(std::exchange(other.ctrl, nullptr)), slots(std::exchange(other.slots, nullptr)),
+          num_slots(std::exchange(other.num_slots, 0)), num_elements(std::exchange(other.num_elements, 0)),
+          growth_left(std::exchange(other.growth_left, 0)) {}
+
+    Table & operator=(Table other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~Table() {
+        release();
+    }
+
+    void swap(Table & other) noexcept {
+        std::swap(ctrl, other.ctrl);
+        std::swap(slots, other.slots);
+        std::swap(num_slots, other.num_slots);
+        std::swap(num_elements, other.num_elements);
+        std::swap(growth_left, other.growth_left);
+    }
+
+    iterator begin() {
+        iterator it(ctrl, slots, slots + num_slots);
+        it.skip_free();
+        return it;
+    }
+    const_iterator begin() const {return const_cast<Table *>(this)->begin();}
+    iterator end() {return iterator(ctrl + num_slots, slots + num_slots, slots + num_slots);}
+    const_iterator end() const {return const_cast<Table *>(this)->end();}
+
+    size_type size() const {return num_elements;}
+    bool empty() const {return num_elements == 0;}
+    size_type capacity() const {return num_slots;}
+
+    /**
+     * Remove every element, the slots stay allocated for the next inserts
+     */
+    void clear() {
+        destroy_elements();
+        if (num_slots > 0) {std::memset(ctrl, EMPTY, num_slots);}
+        num_elements = 0;
+        growth_left = max_load(num_slots);
+    }
+
+    /**
+     * Make room for a number of elements, so inserting up to it doesn't rehash
+     * @param count The number of elements
+     */
+    void reserve(size_type count) {
+        size_type needed = GROUP_WIDTH;
+        while (max_load(needed) < count) {needed *= 2;}
+        if (needed > num_slots) {rehash(needed);}
+    }
+
+    iterator find(const Key & key) {
+        size_type i = find_index(key, hash_of(key));
+        return i == NPOS ? end() : iterator_at(i);
+    }
+    const_iterator find(const Key & key) const {return const_cast<Table *>(this)->find(key);}
+
+    bool contains(const Key & key) const {
+        return find_index(key, hash_of(key)) != NPOS;
+    }
+
+    size_type count(const Key & key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * Insert an element if its key isn't in the table yet
+     * @param value The element
+     * @return Iterator to the element with the key, and whether it was inserted
+     */
+    std::pair<iterator, bool> insert(const Value & value) {
+        return emplace_key(KeyOf()(value), value);
+    }
+    std::pair<iterator, bool> insert(Value && value) {
+        return emplace_key(KeyOf()(value), std::move(value));
+    }
+
+    /**
+     * Remove the element with a key, if any
+     * @param key The key
+     * @return The number of elements removed
+     */
+    size_type erase(const Key & key) {
+        size_type i = find_index(key, hash_of(key));
+        if (i == NPOS) {return 0;}
+        std::destroy_at(slots + i);
+        --num_elements;
+
+        // A probe stops at a group with an empty slot, so none ever went past this group and
+        // the slot can be empty again. Otherwise it's a tombstone, to keep later probes going.
+        if (Group(ctrl + (i & ~(GROUP_WIDTH - 1))).match(EMPTY) != 0) {
+            ctrl[i] = EMPTY;
+            ++growth_left;
+        } else {
+            ctrl[i] = DELETED;
+        }
+        return 1;
+    }
+
+protected:
+    /**
+     * Find the element with a key, or construct one from the arguments
+     * @param key The key, must be the key of the constructed element
+     * @param args Arguments for the element's constructor
+     * @return Iterator to the element with the key, and whether it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace_key(const Key & key, Args &&... args) {
+        uint64_t hash = hash_of(key);
+        size_type i = find_index(key, hash);
+        if (i != NPOS) {return {iterator_at(i), false};}
+        return {iterator_at(insert_new(hash, std::forward<Args>(args)...)), true};
+    }
+
+private:
+    static const size_type NPOS = static_cast<size_type>(-1);
+
+    int8_t *ctrl = nullptr;
+    Value *slots = nullptr;
+    size_type num_slots = 0;
+    size_type num_elements = 0;
+    size_type growth_left = 0;      // Inserts left into empty slots before the load limit of 7/8
+
+    static size_type max_load(size_type capacity) {
+        return capacity - capacity / 8;
+    }
+
+    static uint64_t hash_of(const Key & key) {
+        return mix(Hash()(key));
+    }
+
+    // Low 7 bits pick the control byte, the rest the first group to probe
+    static int8_t control_of(uint64_t hash) {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    size_type first_group(uint64_t hash) const {
+        return (hash >> 7) & (num_slots - 1) & ~(GROUP_WIDTH - 1);
+    }
+
+    iterator iterator_at(size_type i) {
+        return iterator(ctrl + i, slots + i, slots + num_slots);
+    }
+
+    size_type find_index(const Key & key, uint64_t hash) const {
+        if (num_slots == 0) {return NPOS;}
+        int8_t control = control_of(hash);
+        for (size_type group = first_group(hash); ; group = (group + GROUP_WIDTH) & (num_slots - 1)) {
+            Group g(ctrl + group);
+            for (uint32_t mask = g.match(control); mask != 0; mask &= mask - 1) {
+                size_type i = group + __builtin_ctz(mask);
+                if (KeyEqual()(KeyOf()(slots[i]), key)) {return i;}
+            }
+            if (g.match(EMPTY) != 0) {return NPOS;}
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of a hash
+    size_type find_free(uint64_t hash) const {
+        for (size_type group = first_group(hash); ; group = (group + GROUP_WIDTH) & (num_slots - 1)) {
+            uint32_t mask = Group(ctrl + group).match_free();
+            if (mask != 0) {return group + __builtin_ctz(mask);}
+        }
+    }
+
+    // Construct an element whose key is known not to be in the table
+    template <typename... Args>
+    size_type insert_new(uint64_t hash, Args &&... args) {
+        size_type i = num_slots > 0 ? find_free(hash) : NPOS;
+        // Reusing a tombstone doesn't add to the load
+        if (i == NPOS || (growth_left == 0 && ctrl[i] == EMPTY)) {
+            grow();
+            i = find_free(hash);
+        }
+        std::construct_at(slots + i, std::forward<Args>(args)...);
+        if (ctrl[i] == EMPTY) {--growth_left;}
+        ctrl[i] = control_of(hash);
+        ++num_elements;
+        return i;
+    }
+
+    // Double the slots, or only clear out the tombstones if they take most of the load
+    void grow() {
+        if (num_slots > 0 && num_elements < max_load(num_slots) / 2) {
+            rehash(num_slots);
+        } else {
+            rehash(num_slots > 0 ? num_slots * 2 : GROUP_WIDTH);
+        }
+    }
+
+    // Move every element into a new array of slots
+    void rehash(size_type capacity) {
+        int8_t *old_ctrl = std::exchange(ctrl, std::allocator<int8_t>().allocate(capacity));
+        Value *old_slots = std::exchange(slots, std::allocator<Value>().allocate(capacity));
+        size_type old_num_slots = std::exchange(num_slots, capacity);
+        std::memset(ctrl, EMPTY, num_slots);
+        growth_left = max_load(num_slots) - num_elements;
+
+        for (size_type i = 0; i < old_num_slots; ++i) {
+            if (old_ctrl[i] < 0) {continue;}
+            uint64_t hash = hash_of(KeyOf()(old_slots[i]));
+            size_type j = find_free(hash);
+            std::construct_at(slots + j, std::move(old_slots[i]));
+            ctrl[j] = control_of(hash);
+            std::destroy_at(old_slots + i);
+        }
+        if (old_num_slots > 0) {
+            std::allocator<int8_t>().deallocate(old_ctrl, old_num_slots);
+            std::allocator<Value>().deallocate(old_slots, old_num_slots);
+        }
+    }
+
+    void destroy_elements() {
+        if constexpr (!std::is_trivially_destructible_v<Value>) {
+            for (size_type i = 0; i < num_slots; ++i) {
+                if (ctrl[i] >= 0) {std::destroy_at(slots + i);}
+            }
+        }
+    }
+
+    void release() {
+        if (num_slots == 0) {return;}
+        destroy_elements();
+        std::allocator<int8_t>().deallocate(ctrl, num_slots);
+        std::allocator<Value>().deallocate(slots, num_slots);
+    }
+};
+
+
+template <typename Key, typename Mapped>
+struct PairKey {
+    const Key & operator()(const std::pair<const Key, Mapped> & value) const {return value.first;}
+};
+
+template <typename Key>
+struct SelfKey {
+    const Key & operator()(const Key & value) const {return value;}
+};
+
+} // namespace flat_hash
+
+
+/**
+ * Open addressing hash map, see flat_hash_map.h
+ */
+template <typename Key, typename Mapped, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap : public flat_hash::Table<Key, std::pair<const Key, Mapped>, flat_hash::PairKey<Key, Mapped>, Hash, KeyEqual> {
+public:
+    typedef Mapped mapped_type;
+    typedef typename FlatHashMap::Table Base;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    /**
+     * Find the element with a key, or insert one constructed from the arguments
+     * @param key The key
+     * @param args Arguments for the mapped value's constructor
+     * @return Iterator to the element with the key, and whether it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key & key, Args &&... args) {
+        return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    Mapped & operator[](const Key & key) {
+        return try_emplace(key).first->second;
+    }
+
+    Mapped & at(const Key & key) {
+        iterator it = this->find(key);
+        if (it == this->end()) {throw std::out_of_range("FlatHashMap::at");}
+        return it->second;
+    }
+    const Mapped & at(const Key & key) const {
+        return const_cast<FlatHashMap *>(this)->at(key);
+    }
+};
+
+
+/**
+ * Open addressing hash set, see flat_hash_map.h
+ */
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashSet : public flat_hash::Table<Key, Key, flat_hash::SelfKey<Key>, Hash, KeyEqual> {};
+
+} // namespace common
@@ -0,0 +1,215 @@
+#pragma once
+
+/**
+ * Lazy, coroutine based views over an input buffer.
+ *
+ * each_line, each_record and each_field yield string_views into the buffer one at a
+ * time, without building a container, so a loop can stop as soon as it has its answer.
+ * They compose, e.g. the fields of every record:
+ *
+ *   for (std::string_view record : common::each_record(buffer)) {
+ *       for (std::string_view field : common::each_field(record, " \n")) {...}
+ *   }
+ *
+ * The buffer must outlive the generator and every view it yields. Each takes an optional
+ * std::allocator_arg and memory resource first, for the coroutine frame (e.g. an Arena's),
+ * otherwise the frame comes from new/delete.
+ */
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>              // exchange
+#include <algorithm>            // min
+#include <string_view>
+#include <memory>               // allocator_arg_t
+#include <memory_resource>
+#include <cstring>              // memchr, memcpy
+
+
+namespace common {
+
+/**
+ * Single pass range over the values a coroutine yields.
+ * The coroutine runs up to its next co_yield each time the iterator is advanced.
+ */
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        T current{};
+        std::exception_ptr exception;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_always final_suspend() noexcept {return {};}
+        std::suspend_always yield_value(T value) noexcept {
+            current = std::move(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() {exception = std::current_exception();}
+
+        // Frame from the resource a coroutine takes as (std::allocator_arg, resource, ...)
+        template <typename... Args>
+        static void * operator new(std::size_t size, std::allocator_arg_t, std::pmr::memory_resource *resource, const Args &...) {
+            return allocate(size, resource);
+        }
+
+        static void * operator new(std::size_t size) {
+            return allocate(size, std::pmr::new_delete_resource());
+        }
+
+        static void operator delete(void *frame, std::size_t size) {
+            std::pmr::memory_resource *resource;
+            std::memcpy(&resource, static_cast<char *>(frame) + padded(size), sizeof(resource));
+            resource->deallocate(frame, padded(size) + sizeof(resource), alignof(std::max_align_t));
+        }
+
+    private:
+        static std::size_t padded(std::size_t size) {
+            return (size + alignof(std::pmr::memory_resource *) - 1) / alignof(std::pmr::memory_resource *) * alignof(std::pmr::memory_resource *);
+        }
+
+        // The resource is stored after the frame, for operator delete
+        static void * allocate(std::size_t size, std::pmr::memory_resource *resource) {
+            void *frame = resource->allocate(padded(size) + sizeof(resource), alignof(std::max_align_t));
+            std::memcpy(static_cast<char *>(frame) + padded(size), &resource, sizeof(resource));
+            return frame;
+        }
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        const T & operator*() const {return handle.promise().current;}
+        const T * operator->() const {return &handle.promise().current;}
+
+        iterator & operator++() {
+            resume(handle);
+            return *this;
+        }
+        void operator++(int) {++*this;}
+
+        bool operator==(std::default_sentinel_t) const {return !handle || handle.done();}
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    Generator(Generator && other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Generator & operator=(Generator && other) noexcept {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+    Generator(const Generator &) = delete;
+    Generator & operator=(const Generator &) = delete;
+
+    ~Generator() {
+        if (handle) {handle.destroy();}
+    }
+
+    // Runs the coroutine to its first co_yield, can only be called once
+    iterator begin() {
+        resume(handle);
+        return iterator(handle);
+    }
+
+    std::default_sentinel_t end() const {
+        return {};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    // Exceptions thrown by the coroutine surface where it's resumed
+    static void resume(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if (handle.done() && handle.promise().exception) {
+            std::rethrow_exception(handle.promise().exception);
+        }
+    }
+};
+
+
+/**
+ * Lines of a buffer, with the same semantics as split_lines
+ * @param resource Memory resource for the coroutine frame
+ * @param buffer The buffer
+ * @return Generator of views without the newlines
+ */
+inline Generator<std::string_view> each_line(std::allocator_arg_t, [[maybe_unused]] std::pmr::memory_resource *resource, std::string_view buffer) {
+    const char *it = buffer.data(), *end = buffer.data() + buffer.size();
+    while (it < end) {
+        const char *nl = static_cast<const char *>(std::memchr(it, '\n', end - it));
+        if (nl == nullptr) {
+            co_yield std::string_view(it, end - it);
+            break;
+        }
+        co_yield std::string_view(it, nl - it);
+        it = nl + 1;
+    }
+}
+
+inline Generator<std::string_view> each_line(std::string_view buffer) {
+    return each_line(std::allocator_arg, std::pmr::new_delete_resource(), buffer);
+}
+
+
+/**
+ * Records of a buffer, runs of non-blank lines separated by one or more blank lines.
+ * The last record needs no blank line after it.
+ * @param resource Memory resource for the coroutine frames
+ * @param buffer The buffer
+ * @return Generator of views spanning each record's lines, without the trailing newline
+ */
+inline Generator<std::string_view> each_record(std::allocator_arg_t, [[maybe_unused]] std::pmr::memory_resource *resource, std::string_view buffer) {
+    const char *begin = nullptr, *end = nullptr;
+    for (std::string_view line : each_line(std::allocator_arg, resource, buffer)) {
+        if (line.empty()) {
+            if (begin != nullptr) {co_yield std::string_view(begin, end - begin);}
+            begin = nullptr;
+            continue;
+        }
+        if (begin == nullptr) {begin = line.data();}
+        end = line.data() + line.size();
+    }
+    if (begin != nullptr) {co_yield std::string_view(begin, end - begin);}
+}
+
+inline Generator<std::string_view> each_record(std::string_view buffer) {
+    return each_record(std::allocator_arg, std::pmr::new_delete_resource(), buffer);
+}
+
+
+/**
+ * Fields of a string, separated by any run of the delimiters
+ * @param resource Memory resource for the coroutine frame
+ * @param s The string
+ * @param delims Characters separating the fields
+ * @return Generator of the non-empty fields
+ */
+inline Generator<std::string_view> each_field(std::allocator_arg_t, [[maybe_unused]] std::pmr::memory_resource *resource, std::string_view s, std::string_view delims = " ") {
+    std::size_t begin = 0;
+    while ((begin = s.find_first_not_of(delims, begin)) != std::string_view::npos) {
+        std::size_t end = std::min(s.find_first_of(delims, begin), s.size());
+        co_yield s.substr(begin, end - begin);
+        begin = end;
+    }
+}
+
+inline Generator<std::string_view> each_field(std::string_view s, std::string_view delims = " ") {
+    return each_field(std::allocator_arg, std::pmr::new_delete_resource(), s, delims);
+}
+
+} // namespace common
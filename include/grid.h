@@ -0,0 +1,212 @@
+#pragma once
+
+/**
+ * Dense N-dimensional grid in one contiguous allocation, for the cellular automata and maps.
+ *
+ * Cells are stored row-major (the last dimension is contiguous) inside an optional border
+ * of padding cells. With a border of width 1, every inside cell has all 3^N - 1 neighbours
+ * in memory, so a neighbour loop just adds precomputed offsets, without bounds checks.
+ * Two grids of the same shape double buffer a simulation by swap(), which moves no cells.
+ *
+ *   common::Grid<uint8_t> seats({rows, cols}, 1, WALL);
+ *   std::vector<std::ptrdiff_t> neighbours = seats.neighbour_offsets();
+ *   const uint8_t *row = seats.row(r);
+ *   for (std::ptrdiff_t n : neighbours) {occupied += row[c + n] == OCCUPIED;}
+ *
+ * Coordinates of inside cells go from 0 to extent - 1, the border's from -border.
+ */
+
+#include <array>
+#include <vector>
+#include <string_view>
+#include <cstddef>
+#include <utility>              // swap
+#include <algorithm>            // fill
+#include <type_traits>
+#include <stdexcept>            // invalid_argument
+
+
+namespace common {
+
+template <typename T, std::size_t N>
+class GridN {
+    static_assert(N > 0, "A grid needs at least one dimension");
+    static_assert(!std::is_same_v<T, bool>, "std::vector<bool> is packed, use uint8_t cells");
+
+public:
+    typedef std::array<int, N> Index;
+
+    GridN() = default;
+
+    /**
+     * @param extents Size of each dimension, without the border
+     * @param border Width of the padding on every side
+     * @param fill Value of every cell, the border's included
+     */
+    explicit GridN(const Index & extents, int border = 0, const T & fill = T()) : dims(extents), pad(border) {
+        std::size_t total = 1;
+        for (std::size_t d = N; d-- > 0; ) {
+            if (dims[d] < 0 || pad < 0) {throw std::invalid_argument("Negative grid size");}
+            strides[d] = total;
+            total *= dims[d] + 2 * pad;
+        }
+        origin = 0;
+        for (std::size_t d = 0; d < N; ++d) {origin += pad * strides[d];}
+        cells.assign(total, fill);
+    }
+
+    const Index & extents() const {return dims;}
+    int extent(std::size_t dim) const {return dims[dim];}
+    int border() const {return pad;}
+
+    int rows() const requires (N == 2) {return dims[0];}
+    int cols() const requires (N == 2) {return dims[1];}
+
+    /**
+     * @return Number of inside cells, without the border
+     */
+    std::size_t size() const {
+        std::size_t total = 1;
+        for (int extent : dims) {total *= extent;}
+        return total;
+    }
+
+    /**
+     * @param dim The dimension
+     * @return Distance in cells between neighbours along the dimension
+     */
+    std::ptrdiff_t stride(std::size_t dim) const {
+        return strides[dim];
+    }
+
+    /**
+     * @param index Coordinates of a cell, the border's included
+     * @return Position of the cell relative to data()
+     */
+    std::ptrdiff_t offset(const Index & index) const {
+        std::ptrdiff_t result = origin;
+        for (std::size_t d = 0; d < N; ++d) {result += index[d] * strides[d];}
+        return result;
+    }
+
+    T & operator[](const Index & index) {return cells[offset(index)];}
+    const T & operator[](const Index & index) const {return cells[offset(index)];}
+
+    template <typename... Coords> requires (sizeof...(Coords) == N)
+    T & operator()(Coords... coords) {return (*this)[Index{static_cast<int>(coords)...}];}
+    template <typename... Coords> requires (sizeof...(Coords) == N)
+    const T & operator()(Coords... coords) const {return (*this)[Index{static_cast<int>(coords)...}];}
+
+    /**
+     * @param r The row
+     * @return Pointer to the row's first inside cell, its border cells are at negative indices
+     */
+    T * row(int r) requires (N == 2) {return cells.data() + offset({r, 0});}
+    const T * row(int r) const requires (N == 2) {return cells.data() + offset({r, 0});}
+
+    // First cell of the storage, border included, offsets are relative to it
+    T * data() {return cells.data();}
+    const T * data() const {return cells.data();}
+
+    /**
+     * @param index Coordinates of a cell
+     * @return True if the cell is inside the grid, not in its border
+     */
+    bool in_bounds(const Index & index) const {
+        for (std::size_t d = 0; d < N; ++d) {
+            if (index[d] < 0 || index[d] >= dims[d]) {return false;}
+        }
+        return true;
+    }
+
+    /**
+     * Set every cell, the border's included
+     * @param value The value
+     */
+    void fill(const T & value) {
+        std::fill(cells.begin(), cells.end(), value);
+    }
+
+    void swap(GridN & other) noexcept {
+        std::swap(dims, other.dims);
+        std::swap(pad, other.pad);
+        std::swap(strides, other.strides);
+        std::swap(origin, other.origin);
+        cells.swap(other.cells);
+    }
+
+    /**
+     * Offsets from a cell to each of its 3^N - 1 neighbours, in memory order.
+     * Valid from any inside cell when the border is at least 1 wide.
+     * @return The offsets
+     */
+    std::vector<std::ptrdiff_t> neighbour_offsets() const {
+        std::vector<std::ptrdiff_t> offsets = {0};
+        for (std::size_t d = 0; d < N; ++d) {
+            std::vector<std::ptrdiff_t> next;
+            for (std::ptrdiff_t o : offsets) {
+                for (int step = -1; step <= 1; ++step) {next.push_back(o + step * strides[d]);}
+            }
+            offsets.swap(next);
+        }
+        offsets.erase(offsets.begin() + offsets.size() / 2);
+        return offsets;
+    }
+
+    /**
+     * Call a function with the offset of every inside cell, in memory order
+     * @param f Called as f(offset)
+     */
+    template <typename F>
+    void for_each_offset(F && f) const {
+        if (size() == 0) {return;}
+        Index index{};
+        while (true) {
+            std::ptrdiff_t start = offset(index);
+            for (int i = 0; i < dims[N - 1]; ++i) {f(start + i);}
+
+            // Next run along the last dimension, odometer style
+            std::size_t d = N - 1;
+            while (d > 0) {
+                --d;
+                if (++index[d] < dims[d]) {break;}
+                index[d] = 0;
+                if (d == 0) {return;}
+            }
+            if (N == 1) {return;}
+        }
+    }
+
+private:
+    Index dims{};
+    int pad = 0;
+    std::array<std::ptrdiff_t, N> strides{};
+    std::ptrdiff_t origin = 0;
+    std::vector<T> cells;
+};
+
+template <typename T>
+using Grid = GridN<T, 2>;
+
+
+/**
+ * Build a 2D grid from lines of text, one row per line
+ * @param lines The rows, all of the same length
+ * @param to_cell Maps a character to its cell value
+ * @param border Width of the padding on every side
+ * @param fill Value of the border cells
+ * @return The grid
+ */
+template <typename T, typename CellFn>
+Grid<T> grid_from_lines(const std::vector<std::string_view> & lines, CellFn && to_cell, int border = 0, const T & fill = T()) {
+    int cols = lines.empty() ? 0 : lines[0].size();
+    Grid<T> grid({static_cast<int>(lines.size()), cols}, border, fill);
+    for (int r = 0; r < grid.rows(); ++r) {
+        if (static_cast<int>(lines[r].size()) != cols) {throw std::invalid_argument("Grid rows of different lengths");}
+        T *row = grid.row(r);
+        for (int c = 0; c < cols; ++c) {row[c] = to_cell(lines[r][c]);}
+    }
+    return grid;
+}
+
+} // namespace common
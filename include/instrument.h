@@ -0,0 +1,333 @@
+#pragma once
+
+/**
+ * Hot-path instrumentation: scoped timers, counters and histograms.
+ *
+ * Only active when built with AOC_INSTRUMENT (cmake -DAOC_INSTRUMENT=ON), otherwise
+ * every macro expands to nothing and its arguments are not evaluated. Entries are
+ * keyed by name, updates are lock-free so annotated code may run on several threads.
+ * A table is printed to stderr at exit, set AOC_INSTRUMENT_JSON=<path> to also get JSON.
+ * Set AOC_TRACE=<path> to also write every timed scope as a Chrome Trace Event span,
+ * viewable in chrome://tracing or Perfetto.
+ *
+ *   AOC_TIMER("day11.step");              // time the enclosing scope, name must be a literal
+ *   AOC_TRACE_SCOPE("day" + d, "day");    // trace-only span with a runtime name and a category
+ *   AOC_COUNT("day17.neighbours", 26);     // add to a counter
+ *   AOC_HISTOGRAM("day6.group_size", n);   // record a value (log2 buckets)
+ */
+
+#ifdef AOC_INSTRUMENT
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>      // getenv
+#include <unistd.h>     // syscall
+#include <sys/syscall.h>
+
+
+namespace instrument {
+
+struct Timer {
+    std::atomic<uint64_t> calls{0}, total_ns{0}, max_ns{0};
+
+    void record(uint64_t ns) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = max_ns.load(std::memory_order_relaxed);
+        while (ns > prev && !max_ns.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    }
+};
+
+struct Counter {
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t n) {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+};
+
+// Bucket i holds values in [2^(i-1), 2^i), bucket 0 holds 0
+struct Histogram {
+    static const int NUM_BUCKETS = 65;
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> count{0}, sum{0}, min{UINT64_MAX}, max{0};
+
+    void record(uint64_t value) {
+        int bucket = (value == 0) ? 0 : 64 - __builtin_clzll(value);
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t prev = min.load(std::memory_order_relaxed);
+        while (value < prev && !min.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+        prev = max.load(std::memory_order_relaxed);
+        while (value > prev && !max.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+    }
+};
+
+
+// Trace timestamps are relative to program start
+inline const std::chrono::steady_clock::time_point PROGRAM_START = std::chrono::steady_clock::now();
+
+// A completed span for the trace, times in us since program start
+struct TraceEvent {
+    std::string name;
+    const char *category;
+    double start_us, duration_us;
+};
+
+// Spans recorded by one thread, only that thread appends to it
+struct TraceBuffer {
+    long tid;
+    std::vector<TraceEvent> events;
+};
+
+
+/**
+ * Owns every named entry and trace buffer, dumps them when the program exits
+ */
+class Registry {
+public:
+    Registry() {
+        if (const char *path = std::getenv("AOC_TRACE")) {
+            trace_path = path;
+        }
+    }
+
+    Timer & timer(const std::string & name) {
+        return get(timers, name);
+    }
+
+    Counter & counter(const std::string & name) {
+        return get(counters, name);
+    }
+
+    Histogram & histogram(const std::string & name) {
+        return get(histograms, name);
+    }
+
+    bool tracing() const {
+        return !trace_path.empty();
+    }
+
+    double since_origin_us(std::chrono::steady_clock::time_point t) const {
+        return std::chrono::duration<double, std::micro>(t - PROGRAM_START).count();
+    }
+
+    /**
+     * Record a completed span on the calling thread's buffer
+     * @param name Span name
+     * @param category Trace category, e.g. "day" or "hot"
+     * @param start When the span started
+     * @param end When the span ended
+     */
+    void trace(std::string name, const char *category, std::chrono::steady_clock::time_point start,
+               std::chrono::steady_clock::time_point end) {
+        static thread_local TraceBuffer *buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(std::make_unique<TraceBuffer>());
+            buffer = buffers.back().get();
+            buffer->tid = syscall(SYS_gettid);
+        }
+        buffer->events.push_back({std::move(name), category, since_origin_us(start), since_origin_us(end) - since_origin_us(start)});
+    }
+
+    ~Registry() {
+        print_table(std::cerr);
+        if (const char *path = std::getenv("AOC_INSTRUMENT_JSON")) {
+            std::ofstream out(path);
+            print_json(out);
+        }
+        if (tracing()) {
+            std::ofstream out(trace_path);
+            print_trace(out);
+        }
+    }
+
+    // Chrome Trace Event format, one complete ("X") event per span
+    void print_trace(std::ostream & out) const {
+        long pid = getpid();
+        out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        const char *sep = "";
+        for (const auto & buffer : buffers) {
+            for (const auto & e : buffer->events) {
+                out << sep << "\n  {\"name\": \"" << e.name << "\", \"cat\": \"" << e.category << "\", \"ph\": \"X\", \"ts\": "
+                    << e.start_us << ", \"dur\": " << e.duration_us << ", \"pid\": " << pid << ", \"tid\": " << buffer->tid << "}";
+                sep = ",";
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    void print_table(std::ostream & out) const {
+        if (timers.empty() && counters.empty() && histograms.empty()) {return;}
+        out << std::fixed << std::setprecision(3);
+        if (!timers.empty()) {
+            out << std::left << std::setw(32) << "Timer" << std::right << std::setw(12) << "calls"
+                << std::setw(14) << "total (ms)" << std::setw(12) << "mean (us)" << std::setw(12) << "max (us)" << std::endl;
+            for (const auto & [name, t] : timers) {
+                uint64_t calls = t->calls, total = t->total_ns;
+                out << std::left << std::setw(32) << name << std::right << std::setw(12) << calls
+                    << std::setw(14) << total / 1e6 << std::setw(12) << (calls ? total / 1e3 / calls : 0)
+                    << std::setw(12) << t->max_ns / 1e3 << std::endl;
+            }
+        }
+        if (!counters.empty()) {
+            out << std::left << std::setw(32) << "Counter" << std::right << std::setw(12) << "value" << std::endl;
+            for (const auto & [name, c] : counters) {
+                out << std::left << std::setw(32) << name << std::right << std::setw(12) << c->value << std::endl;
+            }
+        }
+        if (!histograms.empty()) {
+            out << std::left << std::setw(32) << "Histogram" << std::right << std::setw(12) << "count"
+                << std::setw(12) << "min" << std::setw(12) << "mean" << std::setw(12) << "max" << "  buckets [lo, hi): n" << std::endl;
+            for (const auto & [name, h] : histograms) {
+                uint64_t count = h->count;
+                out << std::left << std::setw(32) << name << std::right << std::setw(12) << count
+                    << std::setw(12) << (count ? h->min.load() : 0) << std::setw(12) << (count ? static_cast<double>(h->sum) / count : 0)
+                    << std::setw(12) << h->max << " ";
+                for (int i = 0; i < Histogram::NUM_BUCKETS; ++i) {
+                    if (h->buckets[i] == 0) {continue;}
+                    uint64_t lo = (i == 0) ? 0 : 1ULL << (i - 1);
+                    out << " [" << lo << "," << (i == 0 ? 1 : 2 * lo) << "):" << h->buckets[i];
+                }
+                out << std::endl;
+            }
+        }
+    }
+
+    void print_json(std::ostream & out) const {
+        out << "{\n  \"timers\": {";
+        const char *sep = "";
+        for (const auto & [name, t] : timers) {
+            out << sep << "\n    \"" << name << "\": {\"calls\": " << t->calls << ", \"total_ns\": " << t->total_ns
+                << ", \"max_ns\": " << t->max_ns << "}";
+            sep = ",";
+        }
+        out << "\n  },\n  \"counters\": {";
+        sep = "";
+        for (const auto & [name, c] : counters) {
+            out << sep << "\n    \"" << name << "\": " << c->value;
+            sep = ",";
+        }
+        out << "\n  },\n  \"histograms\": {";
+        sep = "";
+        for (const auto & [name, h] : histograms) {
+            out << sep << "\n    \"" << name << "\": {\"count\": " << h->count << ", \"sum\": " << h->sum
+                << ", \"min\": " << (h->count ? h->min.load() : 0) << ", \"max\": " << h->max << ", \"log2_buckets\": [";
+            for (int i = 0; i < Histogram::NUM_BUCKETS; ++i) {
+                out << (i ? ", " : "") << h->buckets[i];
+            }
+            out << "]}";
+            sep = ",";
+        }
+        out << "\n  }\n}\n";
+    }
+
+private:
+    std::mutex mutex;
+    std::string trace_path;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::map<std::string, std::unique_ptr<Timer>> timers;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+
+    template <typename T>
+    T & get(std::map<std::string, std::unique_ptr<T>> & entries, const std::string & name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<T> & entry = entries[name];
+        if (!entry) {entry = std::make_unique<T>();}
+        return *entry;
+    }
+};
+
+inline Registry & registry() {
+    static Registry instance;
+    return instance;
+}
+
+
+/**
+ * Records the lifetime of the enclosing scope into a timer, and as a "hot" span when tracing
+ */
+class ScopedTimer {
+public:
+    ScopedTimer(Timer & timer, const char *name) : timer(timer), name(name), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto end = std::chrono::steady_clock::now();
+        timer.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        if (registry().tracing()) {
+            registry().trace(name, "hot", start, end);
+        }
+    }
+
+private:
+    Timer & timer;
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+};
+
+
+/**
+ * Records the lifetime of the enclosing scope as a span when tracing, nothing otherwise
+ */
+class ScopedSpan {
+public:
+    ScopedSpan(std::string name, const char *category)
+        : name(std::move(name)), category(category), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedSpan() {
+        if (registry().tracing()) {
+            registry().trace(std::move(name), category, start, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    std::string name;
+    const char *category;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace instrument
+
+
+#define AOC_INSTRUMENT_CONCAT_(a, b) a##b
+#define AOC_INSTRUMENT_CONCAT(a, b) AOC_INSTRUMENT_CONCAT_(a, b)
+
+// Each call site looks its entry up once, later hits only touch the atomics
+#define AOC_TIMER(name) \
+    static instrument::Timer & AOC_INSTRUMENT_CONCAT(aoc_timer_, __LINE__) = instrument::registry().timer(name); \
+    instrument::ScopedTimer AOC_INSTRUMENT_CONCAT(aoc_scoped_timer_, __LINE__)(AOC_INSTRUMENT_CONCAT(aoc_timer_, __LINE__), name)
+
+#define AOC_TRACE_SCOPE(name, category) \
+    instrument::ScopedSpan AOC_INSTRUMENT_CONCAT(aoc_span_, __LINE__)(name, category)
+
+#define AOC_COUNT(name, n) do { \
+        static instrument::Counter & aoc_counter = instrument::registry().counter(name); \
+        aoc_counter.add(n); \
+    } while (0)
+
+#define AOC_HISTOGRAM(name, value) do { \
+        static instrument::Histogram & aoc_histogram = instrument::registry().histogram(name); \
+        aoc_histogram.record(value); \
+    } while (0)
+
+#else
+
+#define AOC_TIMER(name) ((void)0)
+#define AOC_TRACE_SCOPE(name, category) ((void)0)
+#define AOC_COUNT(name, n) ((void)0)
+#define AOC_HISTOGRAM(name, value) ((void)0)
+
+#endif
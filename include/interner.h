@@ -0,0 +1,126 @@
+#pragma once
+
+/**
+ * Symbol table mapping each distinct name to a dense 32-bit id.
+ *
+ * Ids count up from 0 in order of first appearance, so data about names can live in
+ * plain vectors indexed by id instead of maps keyed by strings. The names are copied
+ * once into a single character buffer (name i spans [offsets[i], offsets[i + 1]), like
+ * model_cache::StringTable). The index from name to id is an open addressing table of
+ * ids, so it holds no pointers into the buffer and survives the buffer growing.
+ *
+ *   common::Interner colours;
+ *   common::Interner::Id gold = colours.intern("shiny gold");
+ *   std::vector<int> counts(colours.size());
+ *   ++counts[gold];
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>           // hash
+#include <stdexcept>            // length_error
+
+
+namespace common {
+
+class Interner {
+public:
+    typedef uint32_t Id;
+    // Id of a name that was never interned
+    static const Id NONE = static_cast<Id>(-1);
+
+    /**
+     * Get the id of a name, adding it if it's new
+     * @param name The name
+     * @return The name's id
+     */
+    Id intern(std::string_view name) {
+        uint32_t hash = hash_of(name);
+        std::size_t slot = find_slot(name, hash);
+        if (index[slot] != NONE) {return index[slot];}
+
+        // Keep the load under 1/2, growing moves the slot
+        if (2 * (size() + 1) > index.size()) {
+            grow();
+            slot = find_slot(name, hash);
+        }
+        if (chars.size() + name.size() > UINT32_MAX) {throw std::length_error("Interner full");}
+        Id id = size();
+        chars.append(name);
+        offsets.push_back(chars.size());
+        hashes.push_back(hash);
+        index[slot] = id;
+        return id;
+    }
+
+    /**
+     * @param name The name
+     * @return The name's id, or NONE if it was never interned
+     */
+    Id find(std::string_view name) const {
+        return index[find_slot(name, hash_of(name))];
+    }
+
+    /**
+     * @param id An interned id
+     * @return The name, valid until the next intern()
+     */
+    std::string_view name(Id id) const {
+        return std::string_view(chars).substr(offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    /**
+     * @return Number of distinct names, every id is below it
+     */
+    std::size_t size() const {
+        return hashes.size();
+    }
+
+    /**
+     * Make room for a number of names and characters, so interning up to them doesn't reallocate
+     * @param count Number of names
+     * @param total_chars Total length of the names
+     */
+    void reserve(std::size_t count, std::size_t total_chars) {
+        chars.reserve(total_chars);
+        offsets.reserve(count + 1);
+        hashes.reserve(count);
+        while (index.size() < 2 * count) {grow();}
+    }
+
+private:
+    std::string chars;
+    std::vector<uint32_t> offsets = {0};
+    std::vector<uint32_t> hashes;                       // Hash of each name, by id
+    std::vector<Id> index = std::vector<Id>(16, NONE);  // Ids by hash, linear probing
+
+    static uint32_t hash_of(std::string_view name) {
+        return static_cast<uint32_t>(std::hash<std::string_view>()(name));
+    }
+
+    // Slot holding the name's id, or the empty slot where it would go
+    std::size_t find_slot(std::string_view name, uint32_t hash) const {
+        std::size_t mask = index.size() - 1;
+        for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            Id id = index[slot];
+            if (id == NONE || (hashes[id] == hash && this->name(id) == name)) {return slot;}
+        }
+    }
+
+    // Double the index, placing the ids again from their stored hashes
+    void grow() {
+        std::vector<Id> grown(index.size() * 2, NONE);
+        std::size_t mask = grown.size() - 1;
+        for (Id id = 0; id < size(); ++id) {
+            std::size_t slot = hashes[id] & mask;
+            while (grown[slot] != NONE) {slot = (slot + 1) & mask;}
+            grown[slot] = id;
+        }
+        index.swap(grown);
+    }
+};
+
+} // namespace common
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * Reads lines from a file descriptor through a fixed-size buffer, for the streaming
+ * mode of days that fold over their input. Memory use is the buffer, whatever the
+ * input size, so a line must fit in it.
+ *
+ *   common::LineReader reader(STDIN_FILENO);
+ *   std::string_view line;
+ *   while (reader.next(line)) {stream.consume(line);}
+ */
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>              // memchr, memmove, strerror
+#include <unistd.h>             // read
+
+
+namespace common {
+
+class LineReader {
+public:
+    static const std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    /**
+     * @param fd The file descriptor to read, not closed
+     * @param capacity Buffer size, the longest line accepted
+     */
+    explicit LineReader(int fd, std::size_t capacity = DEFAULT_CAPACITY) : fd(fd), buffer(capacity) {}
+
+    /**
+     * Read the next line, with the same semantics as repeated std::getline
+     * @param line Set to the line without its newline, valid until the next call
+     * @return False once the input is exhausted
+     * @throws std::runtime_error on a read error or a line longer than the buffer
+     */
+    bool next(std::string_view & line) {
+        while (true) {
+            const char *begin = buffer.data() + start;
+            const char *nl = static_cast<const char *>(std::memchr(begin, '\n', end - start));
+            if (nl != nullptr) {
+                line = {begin, static_cast<std::size_t>(nl - begin)};
+                start += line.size() + 1;
+                return true;
+            }
+            if (eof) {
+                if (start == end) {return false;}
+                // Last line without a newline
+                line = {begin, end - start};
+                start = end;
+                return true;
+            }
+            fill();
+        }
+    }
+
+    /**
+     * @return Total bytes read so far
+     */
+    std::size_t bytes_read() const {
+        return total;
+    }
+
+private:
+    int fd;
+    std::vector<char> buffer;
+    std::size_t start = 0, end = 0, total = 0;
+    bool eof = false;
+
+    // Move the partial line to the front of the buffer and read more after it
+    void fill() {
+        if (start > 0) {
+            std::memmove(buffer.data(), buffer.data() + start, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (end == buffer.size()) {
+            throw std::runtime_error("Line longer than the " + std::to_string(buffer.size()) + " byte stream buffer");
+        }
+        while (true) {
+            ssize_t n = read(fd, buffer.data() + end, buffer.size() - end);
+            if (n < 0 && errno == EINTR) {continue;}
+            if (n < 0) {throw std::runtime_error(std::string("Read failed: ") + std::strerror(errno));}
+            eof = n == 0;
+            end += n;
+            total += n;
+            return;
+        }
+    }
+};
+
+} // namespace common
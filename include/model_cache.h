@@ -0,0 +1,296 @@
+#pragma once
+
+/**
+ * Binary cache of a day's parsed model, stored next to its input.
+ *
+ * The cache file is named after the input and a hash of its content
+ * (data/2020/day7.txt.<hash>.model), so an edited input never loads a stale model.
+ * Arrays are stored as raw, 8 byte aligned element data. A load maps the file once and
+ * validates it; Reader hands out Spans over the mapping, which are only valid while the
+ * Reader lives. Each day's load_model() bulk-copies the spans into its Parsed type,
+ * rebuilding interners and hash maps where the model has them, so a load skips the
+ * text parsing but still allocates the model.
+ *
+ *   model_cache::Writer writer;
+ *   writer.put_array(program.data(), program.size());
+ *   writer.save(path, hash, MODEL_VERSION);
+ *
+ *   model_cache::Reader reader = ...;
+ *   model_cache::Span<Instruction> program = reader.get_array<Instruction>();
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>          // memcpy
+#include <cstdio>           // rename, remove
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>        // min
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "common.h"
+
+
+namespace model_cache {
+
+// consts
+const char MAGIC[4] = {'A', 'O', 'C', 'M'};
+const uint32_t FORMAT_VERSION = 1;
+const std::size_t ALIGNMENT = 8;
+
+// Fixed size file header, followed by the payload
+struct Header {
+    char magic[4];
+    uint32_t format_version;
+    uint32_t model_version;      // Bumped by a day when its model layout changes
+    uint32_t reserved;
+    uint64_t content_hash;       // Hash of the input the model was parsed from
+    uint64_t payload_size;
+};
+static_assert(sizeof(Header) % ALIGNMENT == 0, "Header must keep the payload aligned");
+
+
+/**
+ * 64 bit FNV-1a hash
+ * @param data The bytes to hash
+ * @return The hash
+ */
+inline uint64_t content_hash(std::string_view data) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @param input_path Path of the input the model is parsed from
+ * @param hash Content hash of the input
+ * @return Path of the cache file, next to the input
+ */
+inline std::string cache_path(const std::string & input_path, uint64_t hash) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4) {
+        hex[i] = HEX[hash & 0xf];
+    }
+    return input_path + "." + hex + ".model";
+}
+
+
+/**
+ * Read-only view over an array stored in the mapped cache file
+ */
+template <typename T>
+struct Span {
+    const T *ptr = nullptr;
+    std::size_t count = 0;
+
+    const T *begin() const {return ptr;}
+    const T *end() const {return ptr + count;}
+    std::size_t size() const {return count;}
+    const T & operator[](std::size_t i) const {return ptr[i];}
+};
+
+/**
+ * Strings packed into one character blob, string i spans [offsets[i], offsets[i + 1])
+ */
+struct StringTable {
+    Span<char> blob;
+    Span<uint32_t> offsets;
+
+    std::size_t size() const {
+        return offsets.size() ? offsets.size() - 1 : 0;
+    }
+
+    std::string_view operator[](std::size_t i) const {
+        return {blob.ptr + offsets[i], offsets[i + 1] - offsets[i]};
+    }
+};
+
+
+/**
+ * Builds a model's payload in memory, then writes it out with its header
+ */
+class Writer {
+public:
+    template <typename T>
+    void put(const T & value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be cached");
+        append(&value, sizeof(T));
+    }
+
+    /**
+     * Store an element count followed by the raw, aligned elements
+     * @param data The elements
+     * @param count Number of elements
+     */
+    template <typename T>
+    void put_array(const T *data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable arrays can be cached");
+        static_assert(alignof(T) <= ALIGNMENT, "Array elements are at most 8 byte aligned");
+        put(static_cast<uint64_t>(count));
+        append(data, count * sizeof(T));
+    }
+
+    /**
+     * Store strings as a single blob plus offsets, read back with Reader::get_strings()
+     * @param strings Range of strings (or string_views)
+     */
+    template <typename Range>
+    void put_strings(const Range & strings) {
+        std::string blob;
+        std::vector<uint32_t> offsets = {0};
+        for (const auto & s : strings) {
+            blob.append(std::string_view(s));
+            offsets.push_back(blob.size());
+        }
+        put_array(blob.data(), blob.size());
+        put_array(offsets.data(), offsets.size());
+    }
+
+    /**
+     * Write the header and payload, through a temporary file so readers never see a partial model
+     * @param path The cache file
+     * @param hash Content hash of the input
+     * @param model_version The day's model layout version
+     * @return True if the file was written
+     */
+    bool save(const std::string & path, uint64_t hash, uint32_t model_version) const {
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.format_version = FORMAT_VERSION;
+        header.model_version = model_version;
+        header.content_hash = hash;
+        header.payload_size = payload.size();
+
+        const std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out) {return false;}
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(payload.data(), payload.size());
+            if (!out) {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    std::string payload;
+
+    // Values are padded to the alignment, so every array starts aligned in the mapped file
+    void append(const void *data, std::size_t size) {
+        payload.append(static_cast<const char *>(data), size);
+        payload.resize((payload.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+    }
+};
+
+
+/**
+ * Reads a model's payload in place from the mapped cache file, in the order it was written
+ */
+class Reader {
+public:
+    /**
+     * @param file The mapped cache file, must outlive the reader and everything read from it
+     * @param hash Content hash of the current input
+     * @param model_version The day's current model layout version
+     */
+    Reader(const common::Input & file, uint64_t hash, uint32_t model_version)
+        : data(file.data()), size(file.size()), offset(sizeof(Header))
+    {
+        Header header;
+        if (size < sizeof(Header)) {return;}
+        std::memcpy(&header, data, sizeof(header));
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+            && header.format_version == FORMAT_VERSION
+            && header.model_version == model_version
+            && header.content_hash == hash
+            && header.payload_size == size - sizeof(Header);
+    }
+
+    /**
+     * @return True if the file holds a model of this version for this input
+     */
+    bool ok() const {
+        return valid;
+    }
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be cached");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    Span<T> get_array() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable arrays can be cached");
+        std::size_t count = get<uint64_t>();
+        if (count > size / sizeof(T)) {throw std::runtime_error("Corrupt model cache");}
+        return {reinterpret_cast<const T *>(take(count * sizeof(T))), count};
+    }
+
+    StringTable get_strings() {
+        StringTable table;
+        table.blob = get_array<char>();
+        table.offsets = get_array<uint32_t>();
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            if (table.offsets[i] > table.offsets[i + 1] || table.offsets[i + 1] > table.blob.size()) {
+                throw std::runtime_error("Corrupt model cache");
+            }
+        }
+        return table;
+    }
+
+private:
+    const char *data;
+    std::size_t size;
+    std::size_t offset;
+    bool valid = false;
+
+    const char *take(std::size_t bytes) {
+        if (bytes > size - offset) {throw std::runtime_error("Truncated model cache");}
+        const char *ptr = data + offset;
+        offset += (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        offset = std::min(offset, size);
+        return ptr;
+    }
+};
+
+
+/**
+ * Load a model from its cache file if there is a valid one
+ * @param path The cache file
+ * @param hash Content hash of the current input
+ * @param model_version The day's current model layout version
+ * @param load Reads the model, called with a valid Reader
+ * @return True if the model was loaded
+ */
+template <typename F>
+bool load(const std::string & path, uint64_t hash, uint32_t model_version, F load) {
+    common::Input file;
+    try {
+        file = common::Input::from_file(path);
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+    try {
+        Reader reader(file, hash, model_version);
+        if (!reader.ok()) {return false;}
+        load(reader);
+        return true;
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+}
+
+} // namespace model_cache
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstring>          // memset, strerror
+#include <cerrno>
+#include <unistd.h>         // syscall, close, read
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+
+namespace perf {
+
+// consts
+enum Event {CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, NUM_EVENTS};
+const std::array<const char *, NUM_EVENTS> EVENT_NAMES = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+// Counter values over one measured region, events which couldn't be opened are not valid
+struct Sample {
+    std::array<double, NUM_EVENTS> values{};
+    std::array<bool, NUM_EVENTS> valid{};
+
+    Sample & operator+=(const Sample & other) {
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+
+    Sample & operator/=(double n) {
+        for (auto & value : values) {value /= n;}
+        return *this;
+    }
+
+    double ipc() const {
+        return (valid[CYCLES] && valid[INSTRUCTIONS] && values[CYCLES] > 0) ? values[INSTRUCTIONS] / values[CYCLES] : 0;
+    }
+};
+
+
+/**
+ * Hardware counters (perf_event_open) for the calling thread, user space only.
+ * Each event is opened on its own so a PMU missing one event still reports the others.
+ * In containers or VMs without a PMU nothing opens, available() is false and
+ * stop() returns a sample with no valid values.
+ */
+class Counters {
+public:
+    Counters() {
+        fds.fill(-1);
+        open_event(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_event(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_event(L1D_MISSES, PERF_TYPE_HW_CACHE,
+                   PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        open_event(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open_event(BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    Counters(const Counters &) = delete;
+    Counters & operator=(const Counters &) = delete;
+
+    ~Counters() {
+        for (int fd : fds) {
+            if (fd >= 0) {close(fd);}
+        }
+    }
+
+    bool available() const {
+        for (int fd : fds) {
+            if (fd >= 0) {return true;}
+        }
+        return false;
+    }
+
+    /**
+     * @return Why the first unavailable event failed to open, empty if all opened
+     */
+    const std::string & error() const {
+        return open_error;
+    }
+
+    void start() {
+        for (int fd : fds) {
+            if (fd < 0) {continue;}
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    /**
+     * Stop counting and read the counts since start(), scaled up if the kernel multiplexed them
+     * @return The counter values
+     */
+    Sample stop() {
+        Sample sample;
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            if (fds[i] < 0) {continue;}
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t data[3];   // value, time enabled, time running
+            if (read(fds[i], data, sizeof(data)) != sizeof(data)) {continue;}
+            sample.values[i] = (data[2] > 0) ? static_cast<double>(data[0]) * data[1] / data[2] : 0;
+            sample.valid[i] = data[2] > 0;
+        }
+        return sample;
+    }
+
+private:
+    std::array<int, NUM_EVENTS> fds;
+    std::string open_error;
+
+    void open_event(Event event, uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[event] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fds[event] < 0 && open_error.empty()) {
+            open_error = std::string(EVENT_NAMES[event]) + ": " + std::strerror(errno);
+        }
+    }
+};
+
+} // namespace perf
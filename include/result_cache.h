@@ -0,0 +1,201 @@
+#pragma once
+
+/**
+ * On-disk cache of solved answers, keyed by (day, part, solver version, input hash).
+ *
+ * Each answer is one small file in the cache directory, named after its key, so
+ * several runs can share a directory. A hit refreshes the file's modification time.
+ * When the files add up to more than the size limit, the least recently used ones
+ * are evicted. Safe to use from several threads.
+ *
+ *   result_cache::Cache cache(dir, 16 << 20);
+ *   result_cache::Key key{day, 2, day15::SOLVER_VERSION, model_cache::content_hash(input)};
+ *   if (auto answer = cache.get(key)) {...} else {cache.put(key, solve());}
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <atomic>
+#include <algorithm>            // sort
+#include <filesystem>
+#include <system_error>
+
+
+namespace result_cache {
+
+// consts
+const char EXTENSION[] = ".result";
+const int FORMAT_VERSION = 1;
+
+// Identifies a single answer
+struct Key {
+    int day;
+    int part;
+    uint32_t solver_version;     // The day's SOLVER_VERSION, bumped when its answers change
+    uint64_t input_hash;
+};
+
+// Cache activity since the cache was opened
+struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+};
+
+
+class Cache {
+public:
+    /**
+     * Open (creating if needed) a cache directory
+     * @param dir The cache directory
+     * @param max_bytes Total size of the cached files to evict down to
+     * @throws std::filesystem::filesystem_error if the directory can't be created
+     */
+    Cache(const std::string & dir, uint64_t max_bytes) : dir(dir), max_bytes(max_bytes) {
+        std::filesystem::create_directories(dir);
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto & entry : list_entries()) {
+            total_bytes += entry.size;
+            ++total_entries;
+        }
+    }
+
+    /**
+     * Look up an answer, a hit marks the entry as recently used
+     * @param key The answer's key
+     * @return The cached answer, if there is one
+     */
+    std::optional<std::string> get(const Key & key) {
+        const std::filesystem::path path = entry_path(key);
+        std::ifstream in(path);
+        std::string header, answer;
+        if (in && std::getline(in, header) && header == entry_header(key) && std::getline(in, answer)) {
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+            ++hits;
+            return answer;
+        }
+        ++misses;
+        return std::nullopt;
+    }
+
+    /**
+     * Store an answer, then evict the least recently used entries if over the size limit
+     * @param key The answer's key
+     * @param answer The answer, a single line
+     */
+    void put(const Key & key, const std::string & answer) {
+        const std::filesystem::path path = entry_path(key);
+        const std::string content = entry_header(key) + "\n" + answer + "\n";
+
+        // Write through a temporary file so concurrent readers never see a partial entry
+        std::filesystem::path tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::trunc);
+            if (!out || !(out << content)) {return;}
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::error_code ec;
+        bool existed = std::filesystem::exists(path, ec);
+        uint64_t old_size = existed ? std::filesystem::file_size(path, ec) : 0;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+        ++stores;
+        total_bytes = total_bytes - old_size + content.size();
+        if (!existed) {++total_entries;}
+        if (total_bytes > max_bytes) {evict();}
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats s;
+        s.hits = hits;
+        s.misses = misses;
+        s.stores = stores;
+        s.evictions = evictions;
+        s.entries = total_entries;
+        s.bytes = total_bytes;
+        return s;
+    }
+
+private:
+    // A cached file, for eviction
+    struct Entry {
+        std::filesystem::path path;
+        uint64_t size;
+        std::filesystem::file_time_type last_used;
+    };
+
+    std::filesystem::path dir;
+    uint64_t max_bytes;
+    mutable std::mutex mutex;
+    std::atomic<uint64_t> hits{0}, misses{0};
+    uint64_t stores = 0, evictions = 0;
+    uint64_t total_bytes = 0, total_entries = 0;
+
+    std::filesystem::path entry_path(const Key & key) const {
+        std::ostringstream name;
+        name << "day" << key.day << "-part" << key.part << "-v" << key.solver_version
+             << "-" << std::hex << key.input_hash << EXTENSION;
+        return dir / name.str();
+    }
+
+    // First line of an entry, guards against a file that doesn't belong to its name
+    static std::string entry_header(const Key & key) {
+        std::ostringstream header;
+        header << "aoc-result " << FORMAT_VERSION << " " << key.day << " " << key.part << " "
+               << key.solver_version << " " << std::hex << key.input_hash;
+        return header.str();
+    }
+
+    std::vector<Entry> list_entries() const {
+        std::vector<Entry> entries;
+        std::error_code ec;
+        for (const auto & file : std::filesystem::directory_iterator(dir, ec)) {
+            if (file.path().extension() != EXTENSION) {continue;}
+            std::error_code size_ec, time_ec;
+            uint64_t size = file.file_size(size_ec);
+            auto last_used = file.last_write_time(time_ec);
+            if (!size_ec && !time_ec) {entries.push_back({file.path(), size, last_used});}
+        }
+        return entries;
+    }
+
+    // Remove least recently used entries until under the limit, other processes may share the
+    // directory so the totals are recounted from disk first. Called with the mutex held.
+    void evict() {
+        std::vector<Entry> entries = list_entries();
+        std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+            return a.last_used < b.last_used;
+        });
+        total_bytes = 0;
+        total_entries = entries.size();
+        for (const auto & entry : entries) {total_bytes += entry.size;}
+
+        for (const auto & entry : entries) {
+            if (total_bytes <= max_bytes) {break;}
+            std::error_code ec;
+            if (std::filesystem::remove(entry.path, ec)) {
+                total_bytes -= entry.size;
+                --total_entries;
+                ++evictions;
+            }
+        }
+    }
+};
+
+} // namespace result_cache
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+
+#include "common.h"
+#include "model_cache.h"
+#include "instrument.h"
+
+
+namespace runner {
+
+// Where parse_cached() got the model from
+enum class CacheStatus {NONE, HIT, MISS};
+
+/**
+ * Type-erased handle over a single day, so every day can be driven from one process.
+ * parse() must be called before the parts, the input buffer must outlive the solver.
+ * clone() copies the parsed state, so both parts can run concurrently on their own copy.
+ */
+struct Solver {
+    virtual ~Solver() = default;
+    virtual void parse(std::string_view input) = 0;
+
+    /**
+     * Parse through the day's binary model cache, if it has one
+     * @param input The input buffer
+     * @param input_path Path the input was read from, the cache file is stored next to it
+     * @return HIT if the model was loaded from the cache, MISS if it was parsed
+     *         (and the cache written), NONE if the day has no cacheable model
+     */
+    virtual CacheStatus parse_cached(std::string_view input, const std::string & /*input_path*/) {
+        parse(input);
+        return CacheStatus::NONE;
+    }
+
+    virtual std::string part1() = 0;
+    virtual std::string part2() = 0;
+    virtual std::unique_ptr<Solver> clone() const = 0;
+};
+
+typedef std::unique_ptr<Solver> (*SolverFactory)();
+
+
+/**
+ * Solver over a day's library API (parse, solve_part1, solve_part2, see 2020/dayN.h)
+ * @tparam Parsed The day's parsed input type
+ * @tparam Parse Builds the parsed input from the input buffer
+ * @tparam Part1 Part 1 solution, takes the parsed input
+ * @tparam Part2 Part 2 solution, takes the parsed input
+ */
+template <typename Parsed, auto Parse, auto Part1, auto Part2>
+struct DaySolver : Solver {
+    Parsed parsed;
+
+    void parse(std::string_view input) override {
+        parsed = Parse(input);
+    }
+
+    std::string part1() override {
+        return std::to_string(Part1(parsed));
+    }
+
+    std::string part2() override {
+        return std::to_string(Part2(parsed));
+    }
+
+    std::unique_ptr<Solver> clone() const override {
+        return std::make_unique<DaySolver>(*this);
+    }
+};
+
+
+/**
+ * DaySolver whose parsed model can be stored in and loaded from a binary cache file
+ * (see model_cache.h), skipping the text parse on repeated runs over the same input
+ * @tparam Save Writes the parsed model, takes a model_cache::Writer and the parsed input
+ * @tparam Load Reads the parsed model back, takes a model_cache::Reader
+ * @tparam ModelVersion The day's model layout version, bump it when Save/Load change
+ */
+template <typename Parsed, auto Parse, auto Part1, auto Part2, auto Save, auto Load, uint32_t ModelVersion>
+struct CachedDaySolver : DaySolver<Parsed, Parse, Part1, Part2> {
+    CacheStatus parse_cached(std::string_view input, const std::string & input_path) override {
+        uint64_t hash = model_cache::content_hash(input);
+        std::string path = model_cache::cache_path(input_path, hash);
+        if (model_cache::load(path, hash, ModelVersion, [&](model_cache::Reader & reader) { this->parsed = Load(reader); })) {
+            AOC_COUNT("model_cache.hits", 1);
+            return CacheStatus::HIT;
+        }
+
+        AOC_COUNT("model_cache.misses", 1);
+        this->parsed = Parse(input);
+        model_cache::Writer writer;
+        Save(writer, this->parsed);
+        writer.save(path, hash, ModelVersion);
+        return CacheStatus::MISS;
+    }
+
+    std::unique_ptr<Solver> clone() const override {
+        return std::make_unique<CachedDaySolver>(*this);
+    }
+};
+
+
+/**
+ * Parse a single day or an inclusive range of days (e.g. 7-9)
+ * @param arg The command line argument
+ * @param max_day The last valid day
+ * @param days Vector to append the days to
+ * @return True if the argument was a valid day/range
+ */
+inline bool parse_days(const std::string & arg, int max_day, std::vector<int> & days) {
+    std::size_t dash = arg.find('-');
+    try {
+        int first = common::to_number<int>(std::string_view(arg).substr(0, dash));
+        int last = (dash == std::string::npos) ? first : common::to_number<int>(std::string_view(arg).substr(dash + 1));
+        if (first < 1 || last > max_day || first > last) {
+            return false;
+        }
+        for (int day = first; day <= last; ++day) {
+            days.push_back(day);
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Wall-clock stopwatch
+ */
+class Stopwatch {
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    void reset() {
+        start = std::chrono::steady_clock::now();
+    }
+
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace runner
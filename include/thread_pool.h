@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>    // max
+
+
+namespace common {
+
+/**
+ * Fixed-size thread pool over a single shared task queue.
+ * Tasks may submit further tasks, wait() returns once the queue is drained and
+ * every worker is idle.
+ */
+class ThreadPool {
+public:
+    /**
+     * Start the workers
+     * @param num_threads Number of worker threads, 0 to use one per hardware thread
+     */
+    explicit ThreadPool(std::size_t num_threads = 0) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        task_available.notify_all();
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queue a task for execution, tasks must not throw
+     * @param task The task to run
+     */
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+            ++pending;
+        }
+        task_available.notify_one();
+    }
+
+    /**
+     * Block until every submitted task (including ones submitted by tasks) has finished
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [this]() { return pending == 0; });
+    }
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    /**
+     * Index of the pool worker running the calling thread
+     * @return The worker index, or -1 if not called from a pool worker
+     */
+    static int worker_index() {
+        return current_worker();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available, all_done;
+    std::size_t pending = 0;
+    bool stopping = false;
+
+    static int & current_worker() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    void worker_loop(std::size_t index) {
+        current_worker() = index;
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (tasks.empty()) {return;}
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                all_done.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace common
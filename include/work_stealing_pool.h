@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <algorithm>    // max
+
+
+namespace common {
+
+/**
+ * Fixed-size thread pool with a task queue per worker.
+ * A worker runs its own newest task first and steals the oldest task from another
+ * worker when its queue is empty, so uneven tasks (day 15 next to day 1) keep every
+ * core busy without contending on one queue. Same interface as ThreadPool.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * Start the workers
+     * @param num_threads Number of worker threads, 0 to use one per hardware thread
+     */
+    explicit WorkStealingPool(std::size_t num_threads = 0) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        task_available.notify_all();
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queue a task for execution, tasks must not throw.
+     * A task submitted by a worker goes on that worker's queue, others are spread round robin.
+     * @param task The task to run
+     */
+    void submit(std::function<void()> task) {
+        ++pending;
+        std::size_t index = current_pool() == this ? current_worker() : next_queue++ % queues.size();
+        {
+            // Counted before it's queued, so a worker never takes more tasks than were counted
+            std::lock_guard<std::mutex> lock(mutex);
+            ++queued;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        task_available.notify_one();
+    }
+
+    /**
+     * Block until every submitted task (including ones submitted by tasks) has finished
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [this]() { return pending == 0; });
+    }
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    /**
+     * @return Number of tasks a worker took from another worker's queue
+     */
+    std::size_t steals() const {
+        return steal_count;
+    }
+
+    /**
+     * Index of the pool worker running the calling thread
+     * @return The worker index, or -1 if not called from a pool worker
+     */
+    static int worker_index() {
+        return current_pool() ? current_worker() : -1;
+    }
+
+private:
+    // Padded to its own cache lines, workers lock their queues constantly
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::mutex mutex;                   // Guards sleeping and waking only
+    std::condition_variable task_available, all_done;
+    std::atomic<std::size_t> pending{0}, queued{0}, next_queue{0}, steal_count{0};
+    bool stopping = false;
+
+    static const WorkStealingPool *& current_pool() {
+        static thread_local const WorkStealingPool *pool = nullptr;
+        return pool;
+    }
+
+    static int & current_worker() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    /**
+     * Take the newest task of the worker's own queue, else the oldest task of another queue
+     * @param index The worker's index
+     * @param task Set to the task
+     * @return True if a task was taken
+     */
+    bool take(std::size_t index, std::function<void()> & task) {
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            Queue & queue = *queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {continue;}
+            if (i == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                ++steal_count;
+            }
+            --queued;
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop(std::size_t index) {
+        current_pool() = this;
+        current_worker() = index;
+        while (true) {
+            std::function<void()> task;
+            if (!take(index, task)) {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_available.wait(lock, [this]() { return stopping || queued > 0; });
+                if (stopping && queued == 0) {return;}
+                continue;
+            }
+
+            task();
+
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                all_done.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace common